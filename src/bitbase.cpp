@@ -132,6 +132,192 @@ namespace {
         result = UNKNOWN;
   }
 
+  // Extended bitbases for KR vs KP and KQ vs KP. The strong side is
+  // normalized to white, the weak black pawn moves down the board and sits on
+  // files A to D, ranks 2 to 7. Unlike KPK the weak side promotes here, and
+  // classifying the resulting KQ vs KR/KQ subgames exactly would need yet
+  // more tables, so a set bit means a *provable* strong-side win: promotions
+  // count as won only when the new piece can be captured outright into a won
+  // position. Unset bits fall back to the heuristic evaluation.
+
+  constexpr unsigned EXT_MAX_INDEX = 1 << 24; // Sparse: some pawn codes unused
+
+  std::bitset<EXT_MAX_INDEX> KRKPBitbase, KQKPBitbase;
+  bool extendedReady = false;
+
+  // Same layout as the KPK index, plus the rook/queen square in bits 18-23
+  unsigned ext_index(Color stm, Square bksq, Square wksq, Square psq, Square pcsq) {
+    return int(wksq) | (bksq << 6) | (stm << 12) | (file_of(psq) << 13)
+         | ((RANK_7 - rank_of(psq)) << 15) | (int(pcsq) << 18);
+  }
+
+  // KR vs K or KQ vs K with black to move: always a win, unless the black
+  // king can capture an undefended piece or is stalemated.
+  bool wins_after_capture(PieceType pt, Square wksq, Square pcsq, Square bksq) {
+
+    Bitboard occ = square_bb(wksq) | square_bb(pcsq);
+    Bitboard att = attacks_bb(pt, pcsq, occ); // bksq excluded, so x-ray through it
+    Bitboard kingMoves = attacks_bb<KING>(bksq) & ~attacks_bb<KING>(wksq);
+
+    if (kingMoves & pcsq)            // Undefended piece falls
+        return false;
+
+    if (kingMoves & ~att & ~occ)     // A safe square to run to: normal win
+        return true;
+
+    return att & bksq;               // No moves at all: mate or stalemate
+  }
+
+  // The black pawn has just promoted on qsq. White wins only if the new piece
+  // can be captured at once into a winning position; anything else is scored
+  // as not won, which is the conservative side of the KQ vs KR/KQ subgames.
+  bool refutes_promotion(PieceType pt, Square wksq, Square pcsq, Square bksq, Square qsq) {
+
+    Bitboard occ = square_bb(wksq) | square_bb(pcsq) | square_bb(bksq) | square_bb(qsq);
+
+    if (   (attacks_bb(pt, pcsq, occ) & qsq)
+        && wins_after_capture(pt, wksq, qsq, bksq))
+        return true;
+
+    return   (attacks_bb<KING>(wksq) & qsq)
+          && !(attacks_bb<KING>(bksq) & qsq)
+          && wins_after_capture(pt, qsq, pcsq, bksq);
+  }
+
+  // Initial classification of an index: invalid, a terminal result, or unknown
+  Result ext_initial(PieceType pt, unsigned idx) {
+
+    Square wksq = Square((idx >>  0) & 0x3F);
+    Square bksq = Square((idx >>  6) & 0x3F);
+    Color  stm  = Color ((idx >> 12) & 0x01);
+    int    rnk  =        (idx >> 15) & 0x7;
+    Square pcsq = Square((idx >> 18) & 0x3F);
+
+    if (rnk > RANK_7 - RANK_2) // Hole in the sparse index range
+        return INVALID;
+
+    Square psq = make_square(File((idx >> 13) & 0x3), Rank(RANK_7 - rnk));
+
+    // Invalid if pieces overlap or if the side not to move is in check
+    Bitboard occ = square_bb(wksq) | square_bb(bksq) | square_bb(psq) | square_bb(pcsq);
+
+    if (   popcount(occ) != 4
+        || distance(wksq, bksq) <= 1
+        || (stm == WHITE && (attacks_bb(pt, pcsq, occ) & bksq))
+        || (stm == BLACK && (pawn_attacks_bb(BLACK, psq) & wksq)))
+        return INVALID;
+
+    if (stm == BLACK)
+    {
+        // Detect mate and stalemate, the only positions without successors
+        Bitboard attX = attacks_bb(pt, pcsq, occ ^ bksq); // X-ray through the king
+        Bitboard kingMoves = attacks_bb<KING>(bksq) & ~attacks_bb<KING>(wksq) & ~square_bb(psq);
+
+        if (   (kingMoves & ~attX)
+            || (kingMoves & pcsq)
+            || (pawn_attacks_bb(BLACK, psq) & pcsq))
+            return UNKNOWN;
+
+        Square t1 = psq + SOUTH;
+        if (   !(occ & t1)
+            && !(attacks_bb(pt, pcsq, occ ^ psq ^ t1) & bksq))
+            return UNKNOWN;
+
+        if (   rank_of(psq) == RANK_7
+            && !(occ & t1)
+            && !(occ & (t1 + SOUTH))
+            && !(attacks_bb(pt, pcsq, occ ^ psq ^ (t1 + SOUTH)) & bksq))
+            return UNKNOWN;
+
+        return (attacks_bb(pt, pcsq, occ) & bksq) ? WIN : DRAW;
+    }
+
+    return UNKNOWN;
+  }
+
+  Result ext_classify(PieceType pt, unsigned idx, std::vector<uint8_t>& db) {
+
+    Square wksq = Square((idx >>  0) & 0x3F);
+    Square bksq = Square((idx >>  6) & 0x3F);
+    Color  stm  = Color ((idx >> 12) & 0x01);
+    Square psq  = make_square(File((idx >> 13) & 0x3), Rank(RANK_7 - ((idx >> 15) & 0x7)));
+    Square pcsq = Square((idx >> 18) & 0x3F);
+
+    const Result Good = (stm == WHITE ? WIN  : DRAW);
+    const Result Bad  = (stm == WHITE ? DRAW : WIN);
+
+    Result r = INVALID;
+    Bitboard occ = square_bb(wksq) | square_bb(bksq) | square_bb(psq) | square_bb(pcsq);
+
+    if (stm == WHITE)
+    {
+        Bitboard b = attacks_bb<KING>(wksq) & ~attacks_bb<KING>(bksq) & ~square_bb(pcsq);
+        while (b)
+        {
+            Square to = pop_lsb(b);
+            r |= to == psq ? (wins_after_capture(pt, to, pcsq, bksq) ? WIN : DRAW)
+                           : Result(db[ext_index(BLACK, bksq, to, psq, pcsq)]);
+        }
+
+        b = attacks_bb(pt, pcsq, occ) & ~square_bb(wksq) & ~square_bb(bksq);
+        while (b)
+        {
+            Square to = pop_lsb(b);
+            r |= to == psq ? (wins_after_capture(pt, wksq, to, bksq) ? WIN : DRAW)
+                           : Result(db[ext_index(BLACK, bksq, wksq, psq, to)]);
+        }
+    }
+    else
+    {
+        Bitboard b = attacks_bb<KING>(bksq) & ~attacks_bb<KING>(wksq) & ~square_bb(psq);
+        while (b)
+        {
+            Square to = pop_lsb(b);
+            r |= to == pcsq ? DRAW // Wins the piece: bare king cannot win KP vs K
+                            : Result(db[ext_index(WHITE, to, wksq, psq, pcsq)]);
+        }
+
+        Square t1 = psq + SOUTH;
+        if (!(occ & t1))
+        {
+            if (rank_of(t1) == RANK_1) // Promotion, if it does not expose the king
+            {
+                if (!(attacks_bb(pt, pcsq, occ ^ psq ^ t1) & bksq))
+                    r |= refutes_promotion(pt, wksq, pcsq, bksq, t1) ? WIN : DRAW;
+            }
+            else
+                r |= Result(db[ext_index(WHITE, bksq, wksq, t1, pcsq)]);
+
+            if (   rank_of(psq) == RANK_7 // Double push
+                && !(occ & (t1 + SOUTH)))
+                r |= Result(db[ext_index(WHITE, bksq, wksq, t1 + SOUTH, pcsq)]);
+        }
+
+        if (pawn_attacks_bb(BLACK, psq) & pcsq)
+            r |= DRAW; // Wins the piece, possibly promoting in the process
+    }
+
+    return Result(db[idx] = r & Good ? Good : r & UNKNOWN ? UNKNOWN : Bad);
+  }
+
+  // Iterate an ending to its fixpoint and fill the bitbase with the wins
+  void ext_solve(PieceType pt, std::bitset<EXT_MAX_INDEX>& bitbase) {
+
+    std::vector<uint8_t> db(EXT_MAX_INDEX);
+    unsigned idx, repeat = 1;
+
+    for (idx = 0; idx < EXT_MAX_INDEX; ++idx)
+        db[idx] = ext_initial(pt, idx);
+
+    while (repeat)
+        for (repeat = idx = 0; idx < EXT_MAX_INDEX; ++idx)
+            repeat |= (db[idx] == UNKNOWN && ext_classify(pt, idx, db) != UNKNOWN);
+
+    for (idx = 0; idx < EXT_MAX_INDEX; ++idx)
+        if (db[idx] == WIN)
+            bitbase.set(idx);
+  }
+
   Result KPKPosition::classify(const std::vector<KPKPosition>& db) {
 
     // White to move: If one move leads to a position classified as WIN, the result
@@ -169,4 +355,35 @@ namespace {
 
 } // namespace
 
+
+/// Bitbases::init_extended() generates the KRKP and KQKP bitbases. It is much
+/// more expensive than init() because of the extra piece dimension, so it runs
+/// only on demand, when the 'Extended Bitbases' option is switched on.
+
+void Bitbases::init_extended() {
+
+  if (extendedReady)
+      return;
+
+  ext_solve(ROOK,  KRKPBitbase);
+  ext_solve(QUEEN, KQKPBitbase);
+  extendedReady = true;
+}
+
+bool Bitbases::extended_ready() { return extendedReady; }
+
+
+/// Probe the KRKP or KQKP bitbase. The caller normalizes the position so that
+/// the side with the rook or queen is white and the black pawn, moving down
+/// the board, is on files A-D. A true return is a provable strong-side win.
+
+bool Bitbases::probe(PieceType pt, Square wksq, Square pcsq, Square bksq, Square psq, Color stm) {
+
+  assert(pt == ROOK || pt == QUEEN);
+  assert(file_of(psq) <= FILE_D);
+
+  unsigned idx = ext_index(stm, bksq, wksq, psq, pcsq);
+  return pt == ROOK ? KRKPBitbase[idx] : KQKPBitbase[idx];
+}
+
 } // namespace Stockfish
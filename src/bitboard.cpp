@@ -38,10 +38,202 @@ Magic BishopMagics[SQUARE_NB];
 
 namespace {
 
-  Bitboard RookTable[0x19000];  // To store rook attacks
-  Bitboard BishopTable[0x1480]; // To store bishop attacks
+  // Magic numbers for the "fancy" approach, one set per index scheme. They
+  // were produced once by the retired PRNG search (seeded per rank, exactly
+  // as before) and frozen here, which allows the whole attack tables to be
+  // generated at compile time below instead of being rebuilt at every
+  // process start. An invalid constant cannot slip through unnoticed: the
+  // table generator fails the constant evaluation on the first colliding
+  // entry.
+
+  constexpr Bitboard RookMagicNumbers[2][SQUARE_NB] = {
+    { // 32-bit index scheme
+      0x1100400000808020ULL, 0x1100400000808020ULL, 0x200A10E0800890ULL, 0x10A00C000800410ULL,
+      0x9080084080810404ULL, 0x4081A0481000201ULL, 0x48600480102008A1ULL, 0x8201228080801249ULL,
+      0x100500000440204ULL, 0x1020031000200804ULL, 0x2010802000082008ULL, 0x2010802000082008ULL,
+      0x20500806801A0022ULL, 0x20500806801A0022ULL, 0x38421000A008022ULL, 0x108442002200811ULL,
+      0x8002C02009010202ULL, 0x2041200441100040ULL, 0x2400300100004420ULL, 0x400090210004042ULL,
+      0x580100800080102ULL, 0x3100C0020020202ULL, 0x5020048820101ULL, 0x2491040100000201ULL,
+      0x1080010200424021ULL, 0x3042050080908022ULL, 0x4820802C020212ULL, 0x1010006420000921ULL,
+      0x58CC050008229801ULL, 0x14400200408901ULL, 0xC008104230680104ULL, 0xD00048201380041ULL,
+      0x40105040900823ULL, 0x40105040900823ULL, 0x80220600008610ULL, 0x80502010008289ULL,
+      0x1640040011120008ULL, 0x80048000A41102ULL, 0x40010000028C4AULL, 0x81004000009601ULL,
+      0x20800000049050ULL, 0x2020200802409009ULL, 0x184202200080441ULL, 0x821000800210010ULL,
+      0x302040201006208ULL, 0x400402220054302ULL, 0x4020808200E001ULL, 0x400404030110081ULL,
+      0x40302000900080ULL, 0x60108080C0086941ULL, 0x41010200C002106ULL, 0x801180800810400AULL,
+      0x41010200C002106ULL, 0x890C80401002004ULL, 0x11B0201000104082ULL, 0x180028090800871ULL,
+      0x280006104304013ULL, 0xA1405140040221ULL, 0x2011482520086005ULL, 0x404405290881822ULL,
+      0x12508C220A640482ULL, 0x818211260000402ULL, 0x12008104000A85ULL, 0x20009023018000C1ULL,
+    },
+    { // 64-bit index scheme
+      0xA80004000801220ULL, 0x8040004010002008ULL, 0x2080200010008008ULL, 0x1100100008210004ULL,
+      0xC200209084020008ULL, 0x2100010004000208ULL, 0x400081000822421ULL, 0x200010422048844ULL,
+      0x800800080400024ULL, 0x1402000401000ULL, 0x3000801000802001ULL, 0x4400800800100083ULL,
+      0x904802402480080ULL, 0x4040800400020080ULL, 0x18808042000100ULL, 0x4040800080004100ULL,
+      0x40048001458024ULL, 0xA0004000205000ULL, 0x3100808010002000ULL, 0x4825010010000820ULL,
+      0x5004808008000401ULL, 0x2024818004000A00ULL, 0x5808002000100ULL, 0x2100060004806104ULL,
+      0x80400880008421ULL, 0x4062220600410280ULL, 0x10A004A00108022ULL, 0x100080080080ULL,
+      0x21000500080010ULL, 0x44000202001008ULL, 0x100400080102ULL, 0xC020128200040545ULL,
+      0x80002000400040ULL, 0x804000802004ULL, 0x120022004080ULL, 0x10A386103001001ULL,
+      0x9010080080800400ULL, 0x8440020080800400ULL, 0x4228824001001ULL, 0x490A000084ULL,
+      0x80002000504000ULL, 0x200020005000C000ULL, 0x12088020420010ULL, 0x10010080080800ULL,
+      0x85001008010004ULL, 0x2000204008080ULL, 0x40413002040008ULL, 0x304081020004ULL,
+      0x80204000800080ULL, 0x3008804000290100ULL, 0x1010100080200080ULL, 0x2008100208028080ULL,
+      0x5000850800910100ULL, 0x8402019004680200ULL, 0x120911028020400ULL, 0x8044010200ULL,
+      0x20850200244012ULL, 0x20850200244012ULL, 0x102001040841ULL, 0x140900040A100021ULL,
+      0x200282410A102ULL, 0x200282410A102ULL, 0x200282410A102ULL, 0x4048240043802106ULL,
+    }
+  };
+
+  constexpr Bitboard BishopMagicNumbers[2][SQUARE_NB] = {
+    { // 32-bit index scheme
+      0x31010A0044021521ULL, 0x80200710301002ULL, 0x4221080080049122ULL, 0x1000124640080581ULL,
+      0x84084410001450C0ULL, 0x900808020A060104ULL, 0x848401C04C0D808ULL, 0x1100A40C3808528ULL,
+      0x4801304440803027ULL, 0x24081202006901BULL, 0x8606120002000401ULL, 0x880102091A82404ULL,
+      0x1040002A20030A32ULL, 0x44201A0160021091ULL, 0x1008080104402244ULL, 0x182203100450909ULL,
+      0x12100C4302280010ULL, 0x9A58410212580017ULL, 0x142058800102009ULL, 0x620A00400008104ULL,
+      0x301148200010002ULL, 0x8900900800204026ULL, 0x105200108024202ULL, 0x420A0410804092ULL,
+      0x4802086023601201ULL, 0x1811040840B00600ULL, 0x900C20004031000ULL, 0x2010201840004400ULL,
+      0x80805008101440ULL, 0x80A00C11006100ULL, 0x424010600114904ULL, 0x424010600114904ULL,
+      0x1220200802021804ULL, 0x814040000015102ULL, 0x6C10180040C04ULL, 0x401880A000000208ULL,
+      0x812480883820042ULL, 0x80808025149011ULL, 0x6C10180040C04ULL, 0x101C2007000812AULL,
+      0x2402120200880202ULL, 0x863244230004108ULL, 0x120820000114108ULL, 0x2090110022400099ULL,
+      0x1410020240000202ULL, 0xB040822001411001ULL, 0x20031000204012AULL, 0x81420500109001C1ULL,
+      0x828000078040105ULL, 0x402063624084424ULL, 0x40B0000124240049ULL, 0x504400000C040252ULL,
+      0x20A050102880092ULL, 0x100220000130A004ULL, 0x8108540051302BULL, 0x708028A2008D1044ULL,
+      0x10940401000A0101ULL, 0x118244024002821ULL, 0x8406062000441221ULL, 0x20A020000030108ULL,
+      0x10020225200102A0ULL, 0x2C6220020400120ULL, 0x80E910800104144ULL, 0x50C200800A982129ULL,
+    },
+    { // 64-bit index scheme
+      0x40106000A1160020ULL, 0x20010250810120ULL, 0x2010010220280081ULL, 0x2806004050C040ULL,
+      0x2021018000000ULL, 0x2001112010000400ULL, 0x881010120218080ULL, 0x1030820110010500ULL,
+      0x120222042400ULL, 0x2000020404040044ULL, 0x8000480094208000ULL, 0x3422A02000001ULL,
+      0xA220210100040ULL, 0x8004820202226000ULL, 0x18234854100800ULL, 0x100004042101040ULL,
+      0x4001004082820ULL, 0x10000810010048ULL, 0x1014004208081300ULL, 0x2080818802044202ULL,
+      0x40880C00A00100ULL, 0x80400200522010ULL, 0x1000188180B04ULL, 0x80249202020204ULL,
+      0x1004400004100410ULL, 0x13100A0022206ULL, 0x2148500001040080ULL, 0x4241080011004300ULL,
+      0x4020848004002000ULL, 0x10101380D1004100ULL, 0x8004422020284ULL, 0x1010A1041008080ULL,
+      0x808080400082121ULL, 0x808080400082121ULL, 0x91128200100C00ULL, 0x202200802010104ULL,
+      0x8C0A020200440085ULL, 0x1A0008080B10040ULL, 0x889520080122800ULL, 0x100902022202010AULL,
+      0x4081A0816002000ULL, 0x681208005000ULL, 0x8170840041008802ULL, 0xA00004200810805ULL,
+      0x830404408210100ULL, 0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+      0x602010120110040ULL, 0x941010801043000ULL, 0x40440A210428ULL, 0x8240020880021ULL,
+      0x400002012048200ULL, 0xAC102001210220ULL, 0x220021002009900ULL, 0x84440C080A013080ULL,
+      0x1008044200440ULL, 0x4C04410841000ULL, 0x2000500104011130ULL, 0x1A0C010011C20229ULL,
+      0x44800112202200ULL, 0x434804908100424ULL, 0x300404822C08200ULL, 0x48081010008A2A80ULL,
+    }
+  };
+
+  // constexpr counterparts of the helpers below, kept free of the runtime
+  // lookup tables (SquareBB, SquareDistance) that are not filled yet when
+  // constant evaluation runs
+
+  constexpr int cx_popcount(Bitboard b) {
+    int cnt = 0;
+    for (; b; b &= b - 1)
+        ++cnt;
+    return cnt;
+  }
+
+  constexpr Bitboard cx_safe_destination(int s, int step) {
+    int to = s + step;
+    int fd = (s & 7) - (to & 7), rd = (s >> 3) - (to >> 3);
+    fd = fd < 0 ? -fd : fd;
+    rd = rd < 0 ? -rd : rd;
+    return 0 <= to && to < SQUARE_NB && (fd > rd ? fd : rd) <= 2 ? Bitboard(1) << to
+                                                                 : Bitboard(0);
+  }
+
+  constexpr Bitboard cx_sliding_attack(PieceType pt, int sq, Bitboard occupied) {
+
+    Bitboard attacks = 0;
+    constexpr int RookDirections[4] = {NORTH, SOUTH, EAST, WEST};
+    constexpr int BishopDirections[4] = {NORTH_EAST, SOUTH_EAST, SOUTH_WEST, NORTH_WEST};
+
+    for (int d : (pt == ROOK ? RookDirections : BishopDirections))
+    {
+        int s = sq;
+        while (cx_safe_destination(s, d) && !(occupied & (Bitboard(1) << s)))
+            attacks |= Bitboard(1) << (s += d);
+    }
+
+    return attacks;
+  }
+
+  // Mirrors Magic::index() for all three schemes; the PEXT instruction is
+  // replaced by its bit-by-bit definition, which constant evaluation allows.
+  constexpr unsigned cx_index(Bitboard occupied, Bitboard mask, Bitboard magic, unsigned shift) {
+
+    if (HasPext)
+    {
+        unsigned result = 0;
+        int i = 0;
+        for (Bitboard m = mask; m; m &= m - 1, ++i)
+            if (occupied & m & -m)
+                result |= 1U << i;
+        return result;
+    }
+
+    if (Is64Bit)
+        return unsigned(((occupied & mask) * magic) >> shift);
+
+    unsigned lo = unsigned(occupied) & unsigned(mask);
+    unsigned hi = unsigned(occupied >> 32) & unsigned(mask >> 32);
+    return (lo * unsigned(magic) ^ hi * unsigned(magic >> 32)) >> shift;
+  }
+
+  template<int TableSize>
+  struct SliderTable {
+    Bitboard attacks[TableSize];
+    Bitboard masks[SQUARE_NB];
+    unsigned offsets[SQUARE_NB];
+    unsigned shifts[SQUARE_NB];
+  };
+
+  // Compile-time version of the retired init_magics(): enumerates every
+  // subset of each square's relevant occupancy with the Carry-Rippler trick
+  // and stores the sliding attack at the index the magic maps it to.
+
+  template<int TableSize>
+  constexpr SliderTable<TableSize> make_slider_table(PieceType pt, const Bitboard* magics) {
+
+    SliderTable<TableSize> t{};
+    int size = 0;
+
+    for (int s = 0; s < SQUARE_NB; ++s)
+    {
+        // Board edges are not considered in the relevant occupancies
+        Bitboard edges = ((Rank1BB | Rank8BB) & ~(Rank1BB << 8 * (s / 8)))
+                       | ((FileABB | FileHBB) & ~(FileABB << (s % 8)));
+
+        Bitboard mask = cx_sliding_attack(pt, s, 0) & ~edges;
+        t.masks[s]   = mask;
+        t.shifts[s]  = (Is64Bit ? 64 : 32) - cx_popcount(mask);
+        t.offsets[s] = unsigned(size);
+
+        Bitboard b = 0;
+        do {
+            Bitboard reference = cx_sliding_attack(pt, s, b);
+            unsigned idx = unsigned(size) + cx_index(b, mask, magics[s], t.shifts[s]);
+
+            // A colliding entry means the magic number is invalid. Reading
+            // past the end of attacks[] is not a constant expression, so the
+            // build fails right here instead of producing a corrupt table.
+            if (t.attacks[idx] && t.attacks[idx] != reference)
+                reference = t.attacks[TableSize];
+
+            t.attacks[idx] = reference;
+            b = (b - mask) & mask;
+        } while (b);
+
+        size += 1 << cx_popcount(mask);
+    }
+
+    return t;
+  }
 
-  void init_magics(PieceType pt, Bitboard table[], Magic magics[]);
+  constexpr auto RookData   = make_slider_table<0x19000>(ROOK,   RookMagicNumbers[Is64Bit]);
+  constexpr auto BishopData = make_slider_table<0x1480>(BISHOP, BishopMagicNumbers[Is64Bit]);
 
 }
 
@@ -89,8 +281,15 @@ void Bitboards::init() {
       for (Square s2 = SQ_A1; s2 <= SQ_H8; ++s2)
           SquareDistance[s1][s2] = std::max(distance<File>(s1, s2), distance<Rank>(s1, s2));
 
-  init_magics(ROOK, RookTable, RookMagics);
-  init_magics(BISHOP, BishopTable, BishopMagics);
+  // The attack tables live in read-only data, computed at compile time and
+  // shared between processes; only the pointers into them are set up here.
+  for (Square s = SQ_A1; s <= SQ_H8; ++s)
+  {
+      RookMagics[s]   = { RookData.masks[s], RookMagicNumbers[Is64Bit][s],
+                          RookData.attacks + RookData.offsets[s], RookData.shifts[s] };
+      BishopMagics[s] = { BishopData.masks[s], BishopMagicNumbers[Is64Bit][s],
+                          BishopData.attacks + BishopData.offsets[s], BishopData.shifts[s] };
+  }
 
   for (Square s1 = SQ_A1; s1 <= SQ_H8; ++s1)
   {
@@ -119,104 +318,4 @@ void Bitboards::init() {
   }
 }
 
-namespace {
-
-  Bitboard sliding_attack(PieceType pt, Square sq, Bitboard occupied) {
-
-    Bitboard attacks = 0;
-    Direction   RookDirections[4] = {NORTH, SOUTH, EAST, WEST};
-    Direction BishopDirections[4] = {NORTH_EAST, SOUTH_EAST, SOUTH_WEST, NORTH_WEST};
-
-    for (Direction d : (pt == ROOK ? RookDirections : BishopDirections))
-    {
-        Square s = sq;
-        while (safe_destination(s, d) && !(occupied & s))
-            attacks |= (s += d);
-    }
-
-    return attacks;
-  }
-
-
-  // init_magics() computes all rook and bishop attacks at startup. Magic
-  // bitboards are used to look up attacks of sliding pieces. As a reference see
-  // www.chessprogramming.org/Magic_Bitboards. In particular, here we use the so
-  // called "fancy" approach.
-
-  void init_magics(PieceType pt, Bitboard table[], Magic magics[]) {
-
-    // Optimal PRNG seeds to pick the correct magics in the shortest time
-    int seeds[][RANK_NB] = { { 8977, 44560, 54343, 38998,  5731, 95205, 104912, 17020 },
-                             {  728, 10316, 55013, 32803, 12281, 15100,  16645,   255 } };
-
-    Bitboard occupancy[4096], reference[4096], edges, b;
-    int epoch[4096] = {}, cnt = 0, size = 0;
-
-    for (Square s = SQ_A1; s <= SQ_H8; ++s)
-    {
-        // Board edges are not considered in the relevant occupancies
-        edges = ((Rank1BB | Rank8BB) & ~rank_bb(s)) | ((FileABB | FileHBB) & ~file_bb(s));
-
-        // Given a square 's', the mask is the bitboard of sliding attacks from
-        // 's' computed on an empty board. The index must be big enough to contain
-        // all the attacks for each possible subset of the mask and so is 2 power
-        // the number of 1s of the mask. Hence we deduce the size of the shift to
-        // apply to the 64 or 32 bits word to get the index.
-        Magic& m = magics[s];
-        m.mask  = sliding_attack(pt, s, 0) & ~edges;
-        m.shift = (Is64Bit ? 64 : 32) - popcount(m.mask);
-
-        // Set the offset for the attacks table of the square. We have individual
-        // table sizes for each square with "Fancy Magic Bitboards".
-        m.attacks = s == SQ_A1 ? table : magics[s - 1].attacks + size;
-
-        // Use Carry-Rippler trick to enumerate all subsets of masks[s] and
-        // store the corresponding sliding attack bitboard in reference[].
-        b = size = 0;
-        do {
-            occupancy[size] = b;
-            reference[size] = sliding_attack(pt, s, b);
-
-            if (HasPext)
-                m.attacks[pext(b, m.mask)] = reference[size];
-
-            size++;
-            b = (b - m.mask) & m.mask;
-        } while (b);
-
-        if (HasPext)
-            continue;
-
-        PRNG rng(seeds[Is64Bit][rank_of(s)]);
-
-        // Find a magic for square 's' picking up an (almost) random number
-        // until we find the one that passes the verification test.
-        for (int i = 0; i < size; )
-        {
-            for (m.magic = 0; popcount((m.magic * m.mask) >> 56) < 6; )
-                m.magic = rng.sparse_rand<Bitboard>();
-
-            // A good magic must map every possible occupancy to an index that
-            // looks up the correct sliding attack in the attacks[s] database.
-            // Note that we build up the database for square 's' as a side
-            // effect of verifying the magic. Keep track of the attempt count
-            // and save it in epoch[], little speed-up trick to avoid resetting
-            // m.attacks[] after every failed attempt.
-            for (++cnt, i = 0; i < size; ++i)
-            {
-                unsigned idx = m.index(occupancy[i]);
-
-                if (epoch[idx] < cnt)
-                {
-                    epoch[idx] = cnt;
-                    m.attacks[idx] = reference[i];
-                }
-                else if (m.attacks[idx] != reference[i])
-                    break;
-            }
-        }
-    }
-  }
-}
-
 } // namespace Stockfish
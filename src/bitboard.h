@@ -30,6 +30,13 @@ namespace Bitbases {
 void init();
 bool probe(Square wksq, Square wpsq, Square bksq, Color us);
 
+// KRKP and KQKP bitbases, generated on demand. A set bit is a provable
+// strong-side win; positions with the pawn promoting into an unresolved
+// KQ vs KR/KQ subgame are conservatively left unset.
+void init_extended();
+bool extended_ready();
+bool probe(PieceType pt, Square wksq, Square pcsq, Square bksq, Square psq, Color stm);
+
 } // namespace Stockfish::Bitbases
 
 namespace Bitboards {
@@ -83,10 +90,10 @@ extern Bitboard PawnAttacks[COLOR_NB][SQUARE_NB];
 
 /// Magic holds all magic bitboards relevant data for a single square
 struct Magic {
-  Bitboard  mask;
-  Bitboard  magic;
-  Bitboard* attacks;
-  unsigned  shift;
+  Bitboard        mask;
+  Bitboard        magic;
+  const Bitboard* attacks; // Points into the compile-time tables in bitboard.cpp
+  unsigned        shift;
 
   // Compute the attack's index using the 'magic bitboards' approach
   unsigned index(Bitboard occupied) const {
@@ -446,6 +453,53 @@ inline Square frontmost_sq(Color c, Bitboard b) {
   return c == WHITE ? msb(b) : lsb(b);
 }
 
+
+/// attacks_bb_many() computes the attack sets of all same-type sliders in
+/// 'sliders' over one shared occupancy. A scalar attacks_bb() per piece
+/// chains an index multiply into a dependent table load; here the batch is
+/// processed in two passes, first generating every table address and only
+/// then issuing the loads, so up to four magic-lookup latencies are in
+/// flight at once instead of serializing. Fills squares[] and attacks[] in
+/// LSB order and returns the number of sliders; the caller must provide
+/// room for all of them (at most 10 of one type can ever exist).
+
+template<PieceType Pt>
+inline int attacks_bb_many(Bitboard sliders, Bitboard occupied, Square* squares, Bitboard* attacks) {
+
+  static_assert(Pt == BISHOP || Pt == ROOK || Pt == QUEEN, "Unsupported piece type");
+
+  int n = 0;
+
+  while (sliders)
+  {
+      const Bitboard* diag[4];
+      const Bitboard* line[4];
+      int cnt = 0;
+
+      while (sliders && cnt < 4)
+      {
+          Square s = pop_lsb(sliders);
+          squares[n + cnt] = s;
+
+          if (Pt != ROOK)
+              diag[cnt] = BishopMagics[s].attacks + BishopMagics[s].index(occupied);
+
+          if (Pt != BISHOP)
+              line[cnt] = RookMagics[s].attacks + RookMagics[s].index(occupied);
+
+          cnt++;
+      }
+
+      for (int i = 0; i < cnt; ++i)
+          attacks[n + i] = Pt == BISHOP ? *diag[i]
+                         : Pt ==   ROOK ? *line[i]
+                                        : *diag[i] | *line[i];
+      n += cnt;
+  }
+
+  return n;
+}
+
 } // namespace Stockfish
 
 #endif // #ifndef BITBOARD_H_INCLUDED
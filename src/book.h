@@ -0,0 +1,42 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BOOK_H_INCLUDED
+#define BOOK_H_INCLUDED
+
+#include <string>
+
+#include "position.h"
+
+namespace Stockfish {
+
+/// The Book namespace implements probing of opening books in the PolyGlot
+/// .bin format. The book is memory mapped once when the 'Book File' option
+/// is set and its sorted entries are binary searched in place, so probing
+/// copies nothing and costs a handful of cache misses.
+
+namespace Book {
+
+void init(const std::string& fname);
+Move probe(const Position& pos);
+
+} // namespace Book
+
+} // namespace Stockfish
+
+#endif // #ifndef BOOK_H_INCLUDED
@@ -0,0 +1,421 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "cluster.h"
+#include "evaluate.h"
+#include "misc.h"
+#include "movegen.h"
+#include "thread.h"
+#include "uci.h"
+
+namespace Stockfish::Cluster {
+
+namespace {
+
+  std::atomic<bool> coordinatingFlag{false};
+
+  // Last line of defense against protocol mishaps: a worker that says
+  // nothing for this long during the handshake is dropped
+  constexpr int HandshakeTimeoutSec = 5;
+
+  // Parsed result of one worker search
+  struct Result {
+    Value value = -VALUE_INFINITE;
+    int depth = 0;
+    std::string bestmove, ponder, pv;
+  };
+
+  // One persistent connection to a remote UCI engine. The connection and
+  // with it the worker's transposition table survive between searches.
+  struct Worker {
+
+    std::string host;
+    int port = 0;
+    int fd = -1;
+    std::string rxBuf;
+
+    std::string name() const { return host + ":" + std::to_string(port); }
+
+    void disconnect() {
+#if !defined(_WIN32)
+      if (fd >= 0)
+          ::close(fd);
+#endif
+      fd = -1;
+      rxBuf.clear();
+    }
+
+#if !defined(_WIN32)
+
+    bool send_line(const std::string& line) {
+
+      std::string msg = line + "\n";
+      for (size_t sent = 0; sent < msg.size(); )
+      {
+          ssize_t n = ::send(fd, msg.data() + sent, msg.size() - sent, 0);
+          if (n <= 0)
+              return disconnect(), false;
+          sent += size_t(n);
+      }
+      return true;
+    }
+
+    bool read_line(std::string& line) {
+
+      size_t eol;
+      while ((eol = rxBuf.find('\n')) == std::string::npos)
+      {
+          char chunk[4096];
+          ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+          if (n <= 0)
+              return disconnect(), false;
+          rxBuf.append(chunk, size_t(n));
+      }
+      line.assign(rxBuf, 0, eol);
+      if (!line.empty() && line.back() == '\r')
+          line.pop_back();
+      rxBuf.erase(0, eol + 1);
+      return true;
+    }
+
+    // Read lines until one starts with the given token, which is returned
+    bool read_until(const std::string& token, std::string& line) {
+
+      while (read_line(line))
+          if (line.compare(0, token.size(), token) == 0)
+              return true;
+      return false;
+    }
+
+    bool connect_and_handshake() {
+
+      struct addrinfo hints = {}, *res;
+      hints.ai_family   = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+
+      if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0)
+          return false;
+
+      for (struct addrinfo* ai = res; ai && fd < 0; ai = ai->ai_next)
+      {
+          fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+          if (fd >= 0 && ::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0)
+              disconnect();
+      }
+      freeaddrinfo(res);
+
+      if (fd < 0)
+          return false;
+
+      struct timeval tv = { HandshakeTimeoutSec, 0 };
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+      std::string line;
+      if (   !send_line("uci")     || !read_until("uciok", line)
+          || !send_line("isready") || !read_until("readyok", line))
+          return disconnect(), false;
+
+      // Searches may legitimately take long, so no timeout from here on
+      tv = { 0, 0 };
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      return true;
+    }
+
+    // Block until the worker's bestmove, keeping score and pv of the last
+    // full info line on the way
+    bool collect(Result& r) {
+
+      std::string line, token;
+
+      while (read_line(line))
+      {
+          std::istringstream is(line);
+          is >> token;
+
+          if (token == "bestmove")
+          {
+              is >> r.bestmove >> token;
+              if (token == "ponder")
+                  is >> r.ponder;
+              return !r.bestmove.empty() && r.value > -VALUE_INFINITE;
+          }
+
+          if (token != "info" || line.find(" score ") == std::string::npos)
+              continue;
+
+          while (is >> token)
+              if (token == "depth")
+                  is >> r.depth;
+              else if (token == "cp")
+              {
+                  int cp;
+                  is >> cp;
+                  r.value = Value(cp * PawnValueEg / 100);
+              }
+              else if (token == "mate")
+              {
+                  int mate;
+                  is >> mate;
+                  r.value = mate > 0 ?  VALUE_MATE - 2 * mate + 1
+                                     : -VALUE_MATE - 2 * mate;
+              }
+              else if (token == "pv")
+              {
+                  std::getline(is, r.pv);
+                  break;
+              }
+      }
+      return false;
+    }
+
+#else
+
+    bool send_line(const std::string&) { return false; }
+    bool collect(Result&) { return false; }
+    bool connect_and_handshake() { return false; }
+
+#endif
+  };
+
+  std::vector<Worker> workers;
+  std::string configuredHosts;
+
+  // Rebuild the worker list when the "Cluster Hosts" option has changed,
+  // dropping existing connections
+  void update_workers() {
+
+    std::string hosts(Options["Cluster Hosts"]);
+
+    if (hosts == configuredHosts)
+        return;
+
+    for (Worker& w : workers)
+        w.disconnect();
+    workers.clear();
+    configuredHosts = hosts;
+
+    std::string entry;
+    std::istringstream is(hosts);
+    while (std::getline(is, entry, ','))
+    {
+        size_t colon = entry.rfind(':');
+        if (colon == std::string::npos)
+            continue;
+
+        Worker w;
+        w.host = entry.substr(0, colon);
+        w.port = atoi(entry.c_str() + colon + 1);
+        if (!w.host.empty() && w.port > 0)
+            workers.push_back(w);
+    }
+  }
+
+  // Translate the coordinator's limits into a "go" command for the workers
+  std::string go_command(const Search::LimitsType& limits) {
+
+    std::ostringstream os;
+    os << "go";
+    if (limits.depth)    os << " depth "    << limits.depth;
+    if (limits.nodes)    os << " nodes "    << limits.nodes;
+    if (limits.movetime) os << " movetime " << limits.movetime;
+    if (limits.mate)     os << " mate "     << limits.mate;
+    return os.str();
+  }
+
+} // anonymous namespace
+
+
+bool available(const Search::LimitsType& limits) {
+
+  return   !std::string(Options["Cluster Hosts"]).empty()
+        &&  limits.searchmoves.empty()
+        && !limits.infinite
+        && !limits.perft
+        && !limits.use_time_management()
+        && (limits.depth || limits.nodes || limits.movetime || limits.mate);
+}
+
+
+bool coordinating() { return coordinatingFlag.load(std::memory_order_relaxed); }
+
+
+/// Cluster::go() partitions the legal root moves round-robin between the
+/// local threads and the connected workers, drives everyone with the same
+/// terminating limit, and prints the bestmove of the highest-scoring
+/// searcher. Workers receive the position as a FEN, so game history before
+/// the root (relevant only to repetition scoring inside their subtree) is
+/// not visible to them. Any worker that fails mid-search is dropped and its
+/// share of the moves is simply lost for this search; the local result
+/// still produces a bestmove.
+
+void go(Position& pos, StateListPtr& states, Search::LimitsType& limits) {
+
+  update_workers();
+
+  std::vector<Worker*> active;
+  for (Worker& w : workers)
+      if (w.fd >= 0 || w.connect_and_handshake())
+          active.push_back(&w);
+      else
+          sync_cout << "info string Cluster worker " << w.name() << " unavailable" << sync_endl;
+
+  std::vector<Move> rootMoves;
+  for (const auto& m : MoveList<LEGAL>(pos))
+      rootMoves.push_back(m);
+
+  // No point in more searchers than root moves
+  while (!active.empty() && active.size() + 1 > rootMoves.size())
+      active.pop_back();
+
+  if (active.empty() || rootMoves.empty())
+  {
+      Threads.start_thinking(pos, states, limits, false);
+      return;
+  }
+
+  const size_t searchers = active.size() + 1;
+  const std::string fen = pos.fen();
+  const std::string goCmd = go_command(limits);
+
+  for (size_t i = 0; i < active.size(); ++i)
+  {
+      std::string cmd = goCmd + " searchmoves";
+      for (size_t j = i + 1; j < rootMoves.size(); j += searchers)
+          cmd += " " + UCI::move(rootMoves[j], pos.is_chess960());
+
+      // Workers must score moves on the same scale as the coordinator
+      if (   !active[i]->send_line(std::string("setoption name Use NNUE value ")
+                                   + (Eval::useNNUE ? "true" : "false"))
+          || !active[i]->send_line("position fen " + fen)
+          || !active[i]->send_line(cmd))
+          sync_cout << "info string Cluster worker " << active[i]->name() << " dropped" << sync_endl;
+  }
+
+  // The coordinator searches slot 0 itself
+  limits.searchmoves.clear();
+  for (size_t j = 0; j < rootMoves.size(); j += searchers)
+      limits.searchmoves.push_back(rootMoves[j]);
+
+  coordinatingFlag = true;
+  Threads.start_thinking(pos, states, limits, false);
+  Threads.main()->wait_for_search_finished();
+
+  Thread* bestThread = int(Options["MultiPV"]) == 1 && !limits.depth
+                     ? Threads.get_best_thread() : Threads.main();
+
+  Value bestValue = bestThread->rootMoves[0].score;
+  std::string bestMove = UCI::move(bestThread->rootMoves[0].pv[0], pos.is_chess960());
+  std::string ponderMove = bestThread->rootMoves[0].pv.size() > 1
+                         ? UCI::move(bestThread->rootMoves[0].pv[1], pos.is_chess960()) : "";
+
+  for (Worker* w : active)
+  {
+      Result r;
+      if (w->fd < 0 || !w->collect(r))
+      {
+          w->disconnect();
+          sync_cout << "info string Cluster worker " << w->name() << " returned no result" << sync_endl;
+          continue;
+      }
+
+      sync_cout << "info string Cluster worker " << w->name() << " depth " << r.depth
+                << " score " << UCI::value(r.value) << " pv" << r.pv << sync_endl;
+
+      if (r.value > bestValue)
+      {
+          bestValue  = r.value;
+          bestMove   = r.bestmove;
+          ponderMove = r.ponder;
+      }
+  }
+
+  coordinatingFlag = false;
+
+  sync_cout << "bestmove " << bestMove;
+  if (!ponderMove.empty())
+      std::cout << " ponder " << ponderMove;
+  std::cout << sync_endl;
+}
+
+
+/// Cluster::serve() turns this process into a worker: accept a single TCP
+/// connection and rebind stdin/stdout to it, so the ordinary UCI loop and
+/// all engine output transparently use the network connection. When the
+/// coordinator disconnects, stdin reaches end-of-file and the engine quits.
+
+void serve(int port) {
+
+#if !defined(_WIN32)
+
+  int srv = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (srv < 0)
+  {
+      sync_cout << "info string Unable to create a server socket" << sync_endl;
+      return;
+  }
+
+  int yes = 1;
+  setsockopt(srv, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  struct sockaddr_in addr = {};
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port        = htons(uint16_t(port));
+
+  if (bind(srv, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || listen(srv, 1) != 0)
+  {
+      sync_cout << "info string Unable to listen on port " << port << sync_endl;
+      ::close(srv);
+      return;
+  }
+
+  std::cerr << "Serving UCI on port " << port << std::endl;
+
+  int client = ::accept(srv, nullptr, nullptr);
+  ::close(srv);
+
+  if (client < 0)
+      return;
+
+  dup2(client, STDIN_FILENO);
+  dup2(client, STDOUT_FILENO);
+  ::close(client);
+
+#else
+
+  (void)port;
+  sync_cout << "info string Cluster serving requires POSIX sockets" << sync_endl;
+
+#endif
+}
+
+} // namespace Stockfish::Cluster
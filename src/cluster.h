@@ -0,0 +1,55 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLUSTER_H_INCLUDED
+#define CLUSTER_H_INCLUDED
+
+#include "position.h"
+#include "search.h"
+
+/// Distributed root search across hosts. Worker engines are plain UCI engines
+/// served over TCP ("./stockfish serve <port>" on the worker side), listed in the
+/// "Cluster Hosts" option on the coordinator as "host:port,host:port,...".
+/// The coordinator partitions the root moves round-robin between itself and
+/// the workers, restricts every searcher with "go ... searchmoves", and
+/// merges the returned scores into a combined bestmove. Workers keep their
+/// connections and transposition tables across searches, so successive
+/// searches of the same game reuse remote work; same-host workers can
+/// additionally share one physical table via "Shared Hash Name".
+
+namespace Stockfish::Cluster {
+
+// True when workers are configured and the limits are ones the coordinator
+// can drive: a terminating fixed limit, no pondering, no time management.
+bool available(const Search::LimitsType& limits);
+
+// True while Cluster::go() owns the search, so the local search must not
+// print its own bestmove
+bool coordinating();
+
+// Distributed counterpart of ThreadPool::start_thinking(), blocking until
+// the local share and all workers are done
+void go(Position& pos, StateListPtr& states, Search::LimitsType& limits);
+
+// Serve UCI over TCP: accept one connection on the port and rebind stdin
+// and stdout to it, then return to the normal UCI loop
+void serve(int port);
+
+} // namespace Stockfish::Cluster
+
+#endif // #ifndef CLUSTER_H_INCLUDED
@@ -62,12 +62,24 @@ namespace {
     return strongSide == WHITE ? sq : flip_rank(sq);
   }
 
+  // Map the board so that the strong side is white and the pawn, which here
+  // belongs to the weak side, is on files A-D. Used by the extended bitbases.
+  Square normalize_weak(const Position& pos, Color strongSide, Square sq) {
+
+    assert(pos.count<PAWN>(~strongSide) == 1);
+
+    if (file_of(pos.square<PAWN>(~strongSide)) >= FILE_E)
+        sq = flip_file(sq);
+
+    return strongSide == WHITE ? sq : flip_rank(sq);
+  }
+
 } // namespace
 
 
 namespace Endgames {
 
-  std::pair<Map<Value>, Map<ScaleFactor>> maps;
+  std::pair<Table<Value>, Table<ScaleFactor>> tables;
 
   void init() {
 
@@ -102,7 +114,7 @@ Value Endgame<KXK>::operator()(const Position& pos) const {
   assert(!pos.checkers()); // Eval is never called when in check
 
   // Stalemate detection with lone king
-  if (pos.side_to_move() == weakSide && !MoveList<LEGAL>(pos).size())
+  if (pos.side_to_move() == weakSide && !pos.has_legal_moves())
       return VALUE_DRAW;
 
   Square strongKing = pos.square<KING>(strongSide);
@@ -188,6 +200,22 @@ Value Endgame<KRKP>::operator()(const Position& pos) const {
   Square queeningSquare = make_square(file_of(weakPawn), relative_rank(weakSide, RANK_8));
   Value result;
 
+  // With the extended bitbase available, provable wins need no heuristics
+  if (Bitbases::extended_ready())
+  {
+      Color us = strongSide == pos.side_to_move() ? WHITE : BLACK;
+
+      if (Bitbases::probe(ROOK,
+                          normalize_weak(pos, strongSide, strongKing),
+                          normalize_weak(pos, strongSide, strongRook),
+                          normalize_weak(pos, strongSide, weakKing),
+                          normalize_weak(pos, strongSide, weakPawn), us))
+      {
+          result = VALUE_KNOWN_WIN + RookValueEg - PawnValueEg - 2 * distance(strongKing, weakPawn);
+          return strongSide == pos.side_to_move() ? result : -result;
+      }
+  }
+
   // If the stronger side's king is in front of the pawn, it's a win
   if (forward_file_bb(strongSide, strongKing) & weakPawn)
       result = RookValueEg - distance(strongKing, weakPawn);
@@ -257,6 +285,22 @@ Value Endgame<KQKP>::operator()(const Position& pos) const {
   Square weakKing   = pos.square<KING>(weakSide);
   Square weakPawn   = pos.square<PAWN>(weakSide);
 
+  // With the extended bitbase available, provable wins need no heuristics
+  if (Bitbases::extended_ready())
+  {
+      Color us = strongSide == pos.side_to_move() ? WHITE : BLACK;
+
+      if (Bitbases::probe(QUEEN,
+                          normalize_weak(pos, strongSide, strongKing),
+                          normalize_weak(pos, strongSide, pos.square<QUEEN>(strongSide)),
+                          normalize_weak(pos, strongSide, weakKing),
+                          normalize_weak(pos, strongSide, weakPawn), us))
+      {
+          Value result = VALUE_KNOWN_WIN + QueenValueEg - PawnValueEg - 2 * distance(strongKing, weakPawn);
+          return strongSide == pos.side_to_move() ? result : -result;
+      }
+  }
+
   Value result = Value(push_close(strongKing, weakKing));
 
   if (   relative_rank(weakSide, weakPawn) != RANK_7
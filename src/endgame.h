@@ -22,7 +22,6 @@
 #include <memory>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 
 #include "position.h"
@@ -88,36 +87,69 @@ struct Endgame : public EndgameBase<T> {
 };
 
 
-/// The Endgames namespace handles the pointers to endgame evaluation and scaling
-/// base objects in two std::map. We use polymorphism to invoke the actual
-/// endgame function by calling its virtual operator().
+/// The Endgames namespace handles the pointers to endgame evaluation and
+/// scaling base objects in two flat open-addressed hash tables indexed
+/// directly by the material key. The specialized set is small and fixed after
+/// init(), so in a sparse power-of-two table a probe settles within a couple
+/// of cache lines instead of walking a node-based map on every Material::probe
+/// miss. We use polymorphism to invoke the actual endgame function by calling
+/// its virtual operator().
 
 namespace Endgames {
 
   template<typename T> using Ptr = std::unique_ptr<EndgameBase<T>>;
-  template<typename T> using Map = std::unordered_map<Key, Ptr<T>>;
 
-  extern std::pair<Map<Value>, Map<ScaleFactor>> maps;
+  template<typename T>
+  struct Table {
+
+    // Power of two comfortably above the number of registrations, so that
+    // linear probing stops after a slot or two. An empty function pointer
+    // marks a free slot; the table is never full.
+    static constexpr size_t Size = 64;
+
+    const EndgameBase<T>* find(Key key) const {
+
+      for (size_t i = key & (Size - 1); entries[i].fn; i = (i + 1) & (Size - 1))
+          if (entries[i].key == key)
+              return entries[i].fn.get();
+
+      return nullptr;
+    }
+
+    void insert(Key key, Ptr<T> fn) {
+
+      size_t i = key & (Size - 1);
+      while (entries[i].fn)
+          i = (i + 1) & (Size - 1);
+
+      entries[i].key = key;
+      entries[i].fn = std::move(fn);
+    }
+
+  private:
+    struct Entry { Key key; Ptr<T> fn; } entries[Size];
+  };
+
+  extern std::pair<Table<Value>, Table<ScaleFactor>> tables;
 
   void init();
 
   template<typename T>
-  Map<T>& map() {
-    return std::get<std::is_same<T, ScaleFactor>::value>(maps);
+  Table<T>& table() {
+    return std::get<std::is_same<T, ScaleFactor>::value>(tables);
   }
 
   template<EndgameCode E, typename T = eg_type<E>>
   void add(const std::string& code) {
 
     StateInfo st;
-    map<T>()[Position().set(code, WHITE, &st).material_key()] = Ptr<T>(new Endgame<E>(WHITE));
-    map<T>()[Position().set(code, BLACK, &st).material_key()] = Ptr<T>(new Endgame<E>(BLACK));
+    table<T>().insert(Position().set(code, WHITE, &st).material_key(), Ptr<T>(new Endgame<E>(WHITE)));
+    table<T>().insert(Position().set(code, BLACK, &st).material_key(), Ptr<T>(new Endgame<E>(BLACK)));
   }
 
   template<typename T>
   const EndgameBase<T>* probe(Key key) {
-    auto it = map<T>().find(key);
-    return it != map<T>().end() ? it->second.get() : nullptr;
+    return table<T>().find(key);
   }
 }
 
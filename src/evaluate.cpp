@@ -31,6 +31,7 @@
 #include "evaluate.h"
 #include "material.h"
 #include "misc.h"
+#include "nnue/nnue_simd_dispatch.h"
 #include "pawns.h"
 #include "thread.h"
 #include "timeman.h"
@@ -73,6 +74,10 @@ namespace Eval {
 
   void NNUE::init() {
 
+    // Decide once whether the host CPU allows upgrading the compile-time
+    // SIMD level of the NNUE kernels via the runtime-dispatched clones.
+    NNUE::Dispatch::init();
+
     useNNUE = Options["Use NNUE"];
     if (!useNNUE)
         return;
@@ -92,9 +97,16 @@ namespace Eval {
         {
             if (directory != "<internal>")
             {
-                ifstream stream(directory + eval_file, ios::binary);
-                if (load_eval(eval_file, stream))
+                // A file in the mapped format is shared zero-copy between
+                // engine processes, anything else goes through the stream loader
+                if (load_mapped_eval(directory + eval_file))
                     eval_file_loaded = eval_file;
+                else
+                {
+                    ifstream stream(directory + eval_file, ios::binary);
+                    if (load_eval(eval_file, stream))
+                        eval_file_loaded = eval_file;
+                }
             }
 
             if (directory == "<internal>" && eval_file == EvalFileDefaultName)
@@ -112,6 +124,12 @@ namespace Eval {
                     eval_file_loaded = eval_file;
             }
         }
+
+    // Accumulations cached in the per-thread refresh tables belong to the
+    // previously loaded network and would be patched with the new net's
+    // column weights, so drop them whenever a network is (re)loaded.
+    for (Thread* th : Threads)
+        th->refreshTable.clear();
   }
 
   /// NNUE::verify() verifies that the last net used was loaded successfully
@@ -150,6 +168,12 @@ namespace Trace {
 
   enum Tracing { NO_TRACE, TRACE };
 
+  // A FAST evaluation settles for a bounded-error value: it skips the
+  // threats and space terms and takes the cached pawn-shelter component of
+  // king safety instead of the full attack-based king danger. The search
+  // selects it through the 'precise' flag at nodes that tolerate it.
+  enum EvalLevel { FULL, FAST };
+
   enum Term { // The first 8 entries are reserved for PieceType
     MATERIAL = 8, IMBALANCE, MOBILITY, THREAT, PASSED, SPACE, WINNABLE, TOTAL, TERM_NB
   };
@@ -283,7 +307,7 @@ namespace {
 #undef S
 
   // Evaluation class computes and stores attacks tables and other working data
-  template<Tracing T>
+  template<Tracing T, EvalLevel Level = FULL>
   class Evaluation {
 
   public:
@@ -342,8 +366,8 @@ namespace {
   // Evaluation::initialize() computes king and pawn attacks, and the king ring
   // bitboard for a given color. This is done at the beginning of the evaluation.
 
-  template<Tracing T> template<Color Us>
-  void Evaluation<T>::initialize() {
+  template<Tracing T, EvalLevel Level> template<Color Us>
+  void Evaluation<T, Level>::initialize() {
 
     constexpr Color     Them = ~Us;
     constexpr Direction Up   = pawn_push(Us);
@@ -382,8 +406,8 @@ namespace {
 
   // Evaluation::pieces() scores pieces of a given color and type
 
-  template<Tracing T> template<Color Us, PieceType Pt>
-  Score Evaluation<T>::pieces() {
+  template<Tracing T, EvalLevel Level> template<Color Us, PieceType Pt>
+  Score Evaluation<T, Level>::pieces() {
 
     constexpr Color     Them = ~Us;
     constexpr Direction Down = -pawn_push(Us);
@@ -395,14 +419,28 @@ namespace {
 
     attackedBy[Us][Pt] = 0;
 
+    // All sliders of one type share their occupancy, including the x-ray
+    // adjustments, so their attack sets are gathered up front with one
+    // batched kernel call whose magic-table loads overlap, instead of a
+    // dependent lookup chain per iteration of the loop below.
+    Square sliderSq[10];
+    Bitboard sliderAttacks[10];
+    int slider = 0;
+
+    if constexpr (Pt != KNIGHT)
+        attacks_bb_many<Pt>(b1,
+                            Pt == BISHOP ? pos.pieces() ^ pos.pieces(QUEEN)
+                          : Pt ==   ROOK ? pos.pieces() ^ pos.pieces(QUEEN) ^ pos.pieces(Us, ROOK)
+                                         : pos.pieces(),
+                            sliderSq, sliderAttacks);
+
     while (b1)
     {
         Square s = pop_lsb(b1);
 
-        // Find attacked squares, including x-ray attacks for bishops and rooks
-        b = Pt == BISHOP ? attacks_bb<BISHOP>(s, pos.pieces() ^ pos.pieces(QUEEN))
-          : Pt ==   ROOK ? attacks_bb<  ROOK>(s, pos.pieces() ^ pos.pieces(QUEEN) ^ pos.pieces(Us, ROOK))
-                         : attacks_bb<Pt>(s, pos.pieces());
+        // Attacked squares, from the batch above (which fills in the same
+        // LSB order) or the pseudo-attack table for knights
+        b = Pt == KNIGHT ? attacks_bb<Pt>(s, pos.pieces()) : sliderAttacks[slider++];
 
         if (pos.blockers_for_king(Us) & s)
             b &= line_bb(pos.square<KING>(Us), s);
@@ -527,8 +565,8 @@ namespace {
 
   // Evaluation::king() assigns bonuses and penalties to a king of a given color
 
-  template<Tracing T> template<Color Us>
-  Score Evaluation<T>::king() const {
+  template<Tracing T, EvalLevel Level> template<Color Us>
+  Score Evaluation<T, Level>::king() const {
 
     constexpr Color    Them = ~Us;
     constexpr Bitboard Camp = (Us == WHITE ? AllSquares ^ Rank6BB ^ Rank7BB ^ Rank8BB
@@ -628,8 +666,8 @@ namespace {
   // Evaluation::threats() assigns bonuses according to the types of the
   // attacking and the attacked pieces.
 
-  template<Tracing T> template<Color Us>
-  Score Evaluation<T>::threats() const {
+  template<Tracing T, EvalLevel Level> template<Color Us>
+  Score Evaluation<T, Level>::threats() const {
 
     constexpr Color     Them     = ~Us;
     constexpr Direction Up       = pawn_push(Us);
@@ -728,8 +766,8 @@ namespace {
   // Evaluation::passed() evaluates the passed pawns and candidate passed
   // pawns of the given color.
 
-  template<Tracing T> template<Color Us>
-  Score Evaluation<T>::passed() const {
+  template<Tracing T, EvalLevel Level> template<Color Us>
+  Score Evaluation<T, Level>::passed() const {
 
     constexpr Color     Them = ~Us;
     constexpr Direction Up   = pawn_push(Us);
@@ -824,8 +862,8 @@ namespace {
   // on ranks 2 to 4. Completely safe squares behind a friendly pawn are counted twice.
   // Finally, the space bonus is multiplied by a weight which decreases according to occupancy.
 
-  template<Tracing T> template<Color Us>
-  Score Evaluation<T>::space() const {
+  template<Tracing T, EvalLevel Level> template<Color Us>
+  Score Evaluation<T, Level>::space() const {
 
     // Early exit if, for example, both queens or 6 minor pieces have been exchanged
     if (pos.non_pawn_material() < SpaceThreshold)
@@ -864,8 +902,8 @@ namespace {
   // the known attacking/defending status of the players. The final value is derived
   // by interpolation from the midgame and endgame values.
 
-  template<Tracing T>
-  Value Evaluation<T>::winnable(Score score) const {
+  template<Tracing T, EvalLevel Level>
+  Value Evaluation<T, Level>::winnable(Score score) const {
 
     int outflanking =  distance<File>(pos.square<KING>(WHITE), pos.square<KING>(BLACK))
                     + int(rank_of(pos.square<KING>(WHITE)) - rank_of(pos.square<KING>(BLACK)));
@@ -962,8 +1000,8 @@ namespace {
   // parts of the evaluation and returns the value of the position from the point
   // of view of the side to move.
 
-  template<Tracing T>
-  Value Evaluation<T>::value() {
+  template<Tracing T, EvalLevel Level>
+  Value Evaluation<T, Level>::value() {
 
     assert(!pos.checkers());
 
@@ -1006,14 +1044,19 @@ namespace {
     score += mobility[WHITE] - mobility[BLACK];
 
     // More complex interactions that require fully populated attack bitboards
-    score +=  king<   WHITE>() - king<   BLACK>()
-            + passed< WHITE>() - passed< BLACK>();
+    if constexpr (Level == FULL)
+        score +=  king<   WHITE>() - king<   BLACK>();
+    else
+        score +=  pe->king_safety<WHITE>(pos) - pe->king_safety<BLACK>(pos);
+
+    score +=  passed< WHITE>() - passed< BLACK>();
 
     if (lazy_skip(LazyThreshold2))
         goto make_v;
 
-    score +=  threats<WHITE>() - threats<BLACK>()
-            + space<  WHITE>() - space<  BLACK>();
+    if constexpr (Level == FULL)
+        score +=  threats<WHITE>() - threats<BLACK>()
+                + space<  WHITE>() - space<  BLACK>();
 
 make_v:
     // Derive single value from mg and eg parts of score
@@ -1079,12 +1122,13 @@ make_v:
 /// evaluate() is the evaluator for the outer world. It returns a static
 /// evaluation of the position from the point of view of the side to move.
 
-Value Eval::evaluate(const Position& pos) {
+Value Eval::evaluate(const Position& pos, bool precise) {
 
   Value v;
 
   if (!Eval::useNNUE)
-      v = Evaluation<NO_TRACE>(pos).value();
+      v = precise ? Evaluation<NO_TRACE>(pos).value()
+                  : Evaluation<NO_TRACE, FAST>(pos).value();
   else
   {
       // Scale and shift NNUE for compatibility with search and classical evaluation
@@ -1108,8 +1152,15 @@ Value Eval::evaluate(const Position& pos) {
       Value psq = Value(abs(eg_value(pos.psq_score())));
       bool classical = psq * 5 > (750 + pos.non_pawn_material() / 64) * (5 + r50);
 
-      v = classical ? Evaluation<NO_TRACE>(pos).value()  // classical
-                    : adjusted_NNUE();                   // NNUE
+      // The classical eval also serves as the cheap tier of an eval cascade:
+      // at nodes the search flags as precision-tolerant (shallow non-PV and
+      // quiescence nodes) it replaces the network, reserving the full NNUE
+      // forward pass for the PV and high-depth nodes that shape the result.
+      // Those nodes also get the reduced FAST pipeline rather than the full
+      // classical one.
+      v = classical ? Evaluation<NO_TRACE>(pos).value()
+        : !precise  ? Evaluation<NO_TRACE, FAST>(pos).value()
+                    : adjusted_NNUE();
   }
 
   // Damp down the evaluation linearly when shuffling
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <optional>
+#include <vector>
 
 #include "types.h"
 
@@ -31,7 +32,10 @@ class Position;
 namespace Eval {
 
   std::string trace(Position& pos);
-  Value evaluate(const Position& pos);
+  // 'precise' selects the expensive tier of the eval cascade; the search
+  // clears it at shallow non-PV and quiescence nodes, where the cheap tier
+  // is accurate enough.
+  Value evaluate(const Position& pos, bool precise = true);
 
   extern bool useNNUE;
   extern std::string eval_file_loaded;
@@ -45,13 +49,16 @@ namespace Eval {
 
     std::string trace(Position& pos);
     Value evaluate(const Position& pos, bool adjusted = false);
+    void benchmark(const std::vector<Position*>& positions, int iterations);
 
     void init();
     void verify();
 
     bool load_eval(std::string name, std::istream& stream);
+    bool load_mapped_eval(const std::string& path);
     bool save_eval(std::ostream& stream);
     bool save_eval(const std::optional<std::string>& filename);
+    bool save_mapped_eval(const std::string& path);
 
   } // namespace NNUE
 
@@ -57,6 +57,81 @@ namespace {
 
   #undef S
 
+  // The imbalance polynomial is precomputed at build time into direct-indexed
+  // tables over one side's piece-count tuple, so that a material probe miss
+  // costs a pair of lookups and a short dot product instead of the doubly
+  // nested loop below. The bounds cover every configuration reachable without
+  // promoted material; the rare positions outside them take the loop.
+  constexpr int ImbPawns  = 9; // 0..8 pawns
+  constexpr int ImbMinors = 3; // 0..2 knights, bishops or rooks
+  constexpr int ImbQueens = 2; // 0..1 queens
+
+  constexpr int ImbConfigs = ImbPawns * ImbMinors * ImbMinors * ImbMinors * ImbQueens;
+
+  constexpr int imb_index(const int pieceCount[PIECE_TYPE_NB]) {
+    return   pieceCount[PAWN]
+           + ImbPawns * (  pieceCount[KNIGHT]
+           + ImbMinors * ( pieceCount[BISHOP]
+           + ImbMinors * ( pieceCount[ROOK]
+           + ImbMinors *   pieceCount[QUEEN])));
+  }
+
+  // mg_value()/eg_value() go through a union and cannot be used in constant
+  // expressions, so the generator unpacks the halves itself.
+  constexpr int imb_mg(Score s) { return int16_t(uint16_t(unsigned(int(s)))); }
+  constexpr int imb_eg(Score s) { return int16_t(uint16_t(unsigned(int(s) + 0x8000) >> 16)); }
+
+  struct ImbalanceTables {
+    // Own-side part of the polynomial for each piece-count tuple
+    Score ours[ImbConfigs];
+    // Coefficients of the cross terms: theirs[idx][pt] is what one of our
+    // pieces of type pt is worth against the opposing tuple idx
+    Score theirs[ImbConfigs][QUEEN + 1];
+  };
+
+  constexpr ImbalanceTables make_imbalance_tables() {
+
+    ImbalanceTables t{};
+
+    for (int pawns = 0; pawns < ImbPawns; ++pawns)
+    for (int knights = 0; knights < ImbMinors; ++knights)
+    for (int bishops = 0; bishops < ImbMinors; ++bishops)
+    for (int rooks = 0; rooks < ImbMinors; ++rooks)
+    for (int queens = 0; queens < ImbQueens; ++queens)
+    {
+        // PIECE_TYPE_NONE is the bishop pair "extended piece", see probe()
+        const int n[QUEEN + 1] = { bishops > 1, pawns, knights, bishops, rooks, queens };
+        const int idx = imb_index(n);
+
+        int mg = 0, eg = 0;
+
+        for (int pt1 = NO_PIECE_TYPE; pt1 <= QUEEN; ++pt1)
+        {
+            int vmg = imb_mg(QuadraticOurs[pt1][pt1]) * n[pt1];
+            int veg = imb_eg(QuadraticOurs[pt1][pt1]) * n[pt1];
+            int cmg = 0, ceg = 0;
+
+            for (int pt2 = NO_PIECE_TYPE; pt2 < pt1; ++pt2)
+            {
+                vmg += imb_mg(QuadraticOurs[pt1][pt2]) * n[pt2];
+                veg += imb_eg(QuadraticOurs[pt1][pt2]) * n[pt2];
+                cmg += imb_mg(QuadraticTheirs[pt1][pt2]) * n[pt2];
+                ceg += imb_eg(QuadraticTheirs[pt1][pt2]) * n[pt2];
+            }
+
+            mg += n[pt1] * vmg;
+            eg += n[pt1] * veg;
+            t.theirs[idx][pt1] = make_score(cmg, ceg);
+        }
+
+        t.ours[idx] = make_score(mg, eg);
+    }
+
+    return t;
+  }
+
+  constexpr ImbalanceTables ImbTables = make_imbalance_tables();
+
   // Endgame evaluation and scaling functions are accessed directly and not through
   // the function maps because they correspond to more than one material hash key.
   Endgame<KXK>    EvaluateKXK[] = { Endgame<KXK>(WHITE),    Endgame<KXK>(BLACK) };
@@ -117,6 +192,14 @@ namespace {
 
 namespace Material {
 
+// Optional process-wide material hash shared by all threads, matching the
+// shared pawn hash in pawns.cpp. Empty (off) by default.
+static SharedHashTable<Entry> sharedTable;
+
+void set_shared_size(size_t mbSize) {
+  sharedTable.resize(mbSize * 1024 * 1024 / sizeof(Entry));
+}
+
 
 /// Material::probe() looks up the current position's material configuration in
 /// the material hash table. It returns a pointer to the Entry if the position
@@ -126,7 +209,8 @@ namespace Material {
 Entry* probe(const Position& pos) {
 
   Key key = pos.material_key();
-  Entry* e = pos.this_thread()->materialTable[key];
+  Entry* e = sharedTable.enabled() ? sharedTable[key]
+                                   : pos.this_thread()->materialTable[key];
 
   if (e->key == key)
       return e;
@@ -220,7 +304,26 @@ Entry* probe(const Position& pos) {
   { pos.count<BISHOP>(BLACK) > 1, pos.count<PAWN>(BLACK), pos.count<KNIGHT>(BLACK),
     pos.count<BISHOP>(BLACK)    , pos.count<ROOK>(BLACK), pos.count<QUEEN >(BLACK) } };
 
-  e->score = (imbalance<WHITE>(pieceCount) - imbalance<BLACK>(pieceCount)) / 16;
+  if (   pieceCount[WHITE][KNIGHT] < ImbMinors && pieceCount[BLACK][KNIGHT] < ImbMinors
+      && pieceCount[WHITE][BISHOP] < ImbMinors && pieceCount[BLACK][BISHOP] < ImbMinors
+      && pieceCount[WHITE][ROOK]   < ImbMinors && pieceCount[BLACK][ROOK]   < ImbMinors
+      && pieceCount[WHITE][QUEEN]  < ImbQueens && pieceCount[BLACK][QUEEN]  < ImbQueens)
+  {
+      const int wIdx = imb_index(pieceCount[WHITE]);
+      const int bIdx = imb_index(pieceCount[BLACK]);
+
+      Score score = ImbTables.ours[wIdx] - ImbTables.ours[bIdx];
+
+      for (int pt = NO_PIECE_TYPE; pt <= QUEEN; ++pt)
+          score +=  ImbTables.theirs[bIdx][pt] * pieceCount[WHITE][pt]
+                  - ImbTables.theirs[wIdx][pt] * pieceCount[BLACK][pt];
+
+      e->score = score / 16;
+  }
+  else
+      // Promoted material beyond the table bounds: evaluate the polynomial
+      e->score = (imbalance<WHITE>(pieceCount) - imbalance<BLACK>(pieceCount)) / 16;
+
   return e;
 }
 
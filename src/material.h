@@ -66,6 +66,10 @@ typedef HashTable<Entry, 8192> Table;
 
 Entry* probe(const Position& pos);
 
+// Sets the size (in MB) of the optional process-wide material hash shared by
+// all threads; a size of zero falls back to the per-thread tables.
+void set_shared_size(size_t mbSize);
+
 } // namespace Stockfish::Material
 
 #endif // #ifndef MATERIAL_H_INCLUDED
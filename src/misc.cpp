@@ -47,8 +47,15 @@ typedef bool(*fun3_t)(HANDLE, CONST GROUP_AFFINITY*, PGROUP_AFFINITY);
 #include <cstdlib>
 
 #if defined(__linux__) && !defined(__ANDROID__)
+#include <cstring>
+#include <fcntl.h>
 #include <stdlib.h>
+#include <sched.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #endif
 
 #if defined(__APPLE__) || defined(__ANDROID__) || defined(__OpenBSD__) || (defined(__GLIBCXX__) && !defined(_GLIBCXX_HAVE_ALIGNED_ALLOC) && !defined(_WIN32)) || defined(__e2k__)
@@ -440,8 +447,57 @@ void* aligned_large_pages_alloc(size_t allocSize) {
 
 #else
 
+#if defined(__linux__) && !defined(__ANDROID__)
+
+namespace {
+
+// Regions mmap'd with MAP_HUGETLB. munmap() needs the mapping length, and the
+// free path must tell these mappings apart from the aligned_alloc() fallback,
+// so we keep a small registry. All (de)allocations happen on the UCI thread
+// while the search is stopped, so no locking is needed.
+struct HugeTLBRegion { void* mem; size_t length; size_t pageSize; };
+std::vector<HugeTLBRegion> hugeTLBRegions;
+
+// hugetlb_alloc() maps allocSize bytes backed by explicitly reserved huge
+// pages of the given size (vm.nr_hugepages and friends), or returns nullptr.
+// Unlike a transparent-hugepage advised allocation such a mapping cannot
+// silently degrade to 4K pages when physical memory is fragmented.
+
+void* hugetlb_alloc(size_t allocSize, size_t pageSize) {
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  // Encode log2(pageSize) in the flags to select the hugetlb pool. The
+  // MAP_HUGE_2MB/MAP_HUGE_1GB macros are missing from older kernel headers.
+  int pageSizeFlag = __builtin_ctzll(pageSize) << MAP_HUGE_SHIFT;
+
+  size_t size = (allocSize + pageSize - 1) & ~(pageSize - 1);
+  void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | pageSizeFlag, -1, 0);
+  if (mem == MAP_FAILED)
+      return nullptr;
+
+  hugeTLBRegions.push_back({ mem, size, pageSize });
+  return mem;
+#else
+  (void)allocSize, (void)pageSize;
+  return nullptr;
+#endif
+}
+
+} // namespace
+
+#endif
+
 void* aligned_large_pages_alloc(size_t allocSize) {
 
+#if defined(__linux__) && !defined(__ANDROID__)
+  // Prefer explicitly reserved huge pages, trying 1GB then 2MB ones
+  for (size_t pageSize : { size_t(1) << 30, size_t(1) << 21 })
+      if (allocSize >= pageSize)
+          if (void* mem = hugetlb_alloc(allocSize, pageSize))
+              return mem;
+#endif
+
 #if defined(__linux__)
   constexpr size_t alignment = 2 * 1024 * 1024; // assumed 2MB page size
 #else
@@ -460,6 +516,49 @@ void* aligned_large_pages_alloc(size_t allocSize) {
 #endif
 
 
+/// large_page_size() returns the size of the pages explicitly obtained for a
+/// block returned by aligned_large_pages_alloc(), or 0 when the block is only
+/// transparent-hugepage advised and the effective page size is up to the kernel.
+
+size_t large_page_size(const void* mem) {
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  for (const HugeTLBRegion& region : hugeTLBRegions)
+      if (region.mem == mem)
+          return region.pageSize;
+#else
+  (void)mem;
+#endif
+  return 0;
+}
+
+
+/// numa_interleave() spreads the backing pages of [mem, mem + size) evenly
+/// across all NUMA nodes with mbind(MPOL_INTERLEAVE). This suits memory that
+/// is accessed uniformly by threads on every node, like the transposition
+/// table, where first-touch placement would make all of it local to whichever
+/// threads zeroed it. A no-op on single-node systems and on platforms without
+/// mbind(). Must be called before the pages are first touched.
+
+void numa_interleave(void* mem, size_t size) {
+
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+  int nodes = 0;
+  while (std::ifstream("/sys/devices/system/node/node" + std::to_string(nodes) + "/cpulist"))
+      ++nodes;
+
+  if (nodes < 2 || nodes > 64) // a single 64-bit mask is enough in practice
+      return;
+
+  constexpr int MPOL_INTERLEAVE = 3; // from <numaif.h>, avoiding the libnuma dependency
+  unsigned long nodeMask = nodes == 64 ? ~0UL : (1UL << nodes) - 1;
+  syscall(SYS_mbind, mem, size, MPOL_INTERLEAVE, &nodeMask, nodes + 1, 0);
+#else
+  (void)mem, (void)size;
+#endif
+}
+
+
 /// aligned_large_pages_free() will free the previously allocated ttmem
 
 #if defined(_WIN32)
@@ -479,15 +578,288 @@ void aligned_large_pages_free(void* mem) {
 #else
 
 void aligned_large_pages_free(void *mem) {
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  for (auto it = hugeTLBRegions.begin(); it != hugeTLBRegions.end(); ++it)
+      if (it->mem == mem)
+      {
+          munmap(mem, it->length);
+          hugeTLBRegions.erase(it);
+          return;
+      }
+#endif
+
   std_aligned_free(mem);
 }
 
 #endif
 
 
+/// PerfEventGroup methods open, read and close the hardware counters. The
+/// counters are created disabled with inherit set, so that worker threads
+/// spawned after start() are counted too, then enabled as a last step.
+
+#if defined(__linux__) && !defined(__ANDROID__)
+
+bool PerfEventGroup::start() {
+
+  struct EventSpec { uint32_t type; uint64_t config; };
+
+  constexpr EventSpec Specs[4] = {
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+      { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+  };
+
+  for (int i = 0; i < 4; ++i)
+  {
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = Specs[i].type;
+      attr.config = Specs[i].config;
+      attr.disabled = 1;
+      attr.inherit = 1; // Count threads created after this point as well
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      fds[i] = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+
+      if (fds[i] < 0)
+      {
+          stop();
+          return false;
+      }
+  }
+
+  for (int fd : fds)
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0), ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+
+  return true;
+}
+
+void PerfEventGroup::stop() {
+
+  uint64_t* counts[4] = { &cycles, &l1dMisses, &llcMisses, &branchMisses };
+
+  for (int i = 0; i < 4; ++i)
+      if (fds[i] >= 0)
+      {
+          ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+          if (read(fds[i], counts[i], sizeof(uint64_t)) != sizeof(uint64_t))
+              *counts[i] = 0;
+          close(fds[i]);
+          fds[i] = -1;
+      }
+}
+
+#else
+
+bool PerfEventGroup::start() { return false; }
+void PerfEventGroup::stop() {}
+
+#endif
+
+
+/// Telemetry maps a single small block shared from the given file. The writer
+/// side of the seqlock lives in publish(); a reader maps the same file
+/// read-only, and retries a sample whenever the sequence field was odd or
+/// changed while the payload was being copied.
+
+namespace Telemetry {
+
+namespace {
+
+  struct Block {
+    uint64_t magic;    // Layout tag, so readers can sanity-check the file
+    uint64_t sequence; // Odd while an update is in flight
+    uint64_t nodes;
+    uint64_t tbHits;
+    uint64_t hashfull;
+    uint64_t depth;
+    uint64_t elapsed;  // Milliseconds since the search started
+  };
+
+  constexpr uint64_t Magic = 0x5346544D00000001ULL; // "SFTM" + layout version 1
+
+  Block* block = nullptr;
+  TimePoint lastPublish = 0;
+}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+
+void open(const std::string& fname) {
+
+  close();
+
+  if (fname.empty())
+      return;
+
+  int fd = ::open(fname.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0)
+  {
+      std::cerr << "Unable to open telemetry file " << fname << std::endl;
+      return;
+  }
+
+  if (ftruncate(fd, sizeof(Block)) == 0)
+  {
+      void* mem = mmap(nullptr, sizeof(Block), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (mem != MAP_FAILED)
+      {
+          block = static_cast<Block*>(mem);
+          std::memset(block, 0, sizeof(Block));
+          block->magic = Magic;
+      }
+  }
+  ::close(fd);
+}
+
+void close() {
+
+  if (block)
+  {
+      munmap(block, sizeof(Block));
+      block = nullptr;
+  }
+}
+
+#else
+
+void open(const std::string&) {}
+void close() {}
+
+#endif
+
+bool due(TimePoint elapsed) {
+
+  // Publish at most every 10ms; a smaller elapsed means a new search started
+  if (!block || (elapsed >= lastPublish && elapsed < lastPublish + 10))
+      return false;
+
+  lastPublish = elapsed;
+  return true;
+}
+
+void publish(uint64_t nodes, uint64_t tbHits, int hashfull,
+             int depth, TimePoint elapsed) {
+
+  if (!block)
+      return;
+
+  // Seqlock write side: bump the sequence to odd, store the payload, bump
+  // back to even. The fences keep the payload stores between the sequence
+  // stores for readers in other processes; there is only one writer.
+  const uint64_t s = block->sequence;
+
+  block->sequence = s + 1;
+  std::atomic_thread_fence(std::memory_order_release);
+
+  block->nodes    = nodes;
+  block->tbHits   = tbHits;
+  block->hashfull = uint64_t(hashfull);
+  block->depth    = uint64_t(depth);
+  block->elapsed  = uint64_t(elapsed);
+
+  std::atomic_thread_fence(std::memory_order_release);
+  block->sequence = s + 2;
+}
+
+} // namespace Telemetry
+
+
 namespace WinProcGroup {
 
-#ifndef _WIN32
+#if defined(__linux__) && !defined(__ANDROID__)
+
+/// Linux NUMA support reads the topology from sysfs, so there is no dependency
+/// on libnuma. Threads are distributed across the online nodes in the same way
+/// as with the Windows processor-group code below: fill up one node before
+/// moving on to the next one. With the threads pinned before they first touch
+/// their data, the kernel's first-touch policy places the backing pages on the
+/// local node.
+
+/// read_cpulist() parses a sysfs cpu list like "0-31,64-95" into cpu ids
+
+static std::vector<int> read_cpulist(const std::string& path) {
+
+  std::vector<int> cpus;
+  std::ifstream ifs(path);
+  std::string token;
+
+  while (std::getline(ifs, token, ','))
+  {
+      size_t dash = token.find('-');
+      int first = atoi(token.c_str());
+      int last  = dash == std::string::npos ? first : atoi(token.c_str() + dash + 1);
+
+      for (int c = first; c <= last; ++c)
+          cpus.push_back(c);
+  }
+  return cpus;
+}
+
+
+/// best_node() returns the cpus of the node the thread with index idx should
+/// be pinned to, or an empty list when binding is not worthwhile.
+
+static std::vector<int> best_node(size_t idx) {
+
+  std::vector<std::vector<int>> nodes;
+
+  for (int n = 0; ; ++n)
+  {
+      std::vector<int> cpus =
+          read_cpulist("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+
+      if (cpus.empty())
+          break;
+
+      nodes.push_back(cpus);
+  }
+
+  // On a single node (or without sysfs) leave scheduling to the OS
+  if (nodes.size() < 2)
+      return {};
+
+  // Run as many threads as possible on the same node until its cpus are
+  // exhausted, then move on filling the next node.
+  for (const auto& cpus : nodes)
+  {
+      if (idx < cpus.size())
+          return cpus;
+
+      idx -= cpus.size();
+  }
+
+  // More threads than logical processors: spread the rest evenly
+  return nodes[idx % nodes.size()];
+}
+
+
+/// bindThisThread() pins the current thread to the cpus of its NUMA node
+
+void bindThisThread(size_t idx) {
+
+  std::vector<int> cpus = best_node(idx);
+
+  if (cpus.empty())
+      return;
+
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+
+  for (int c : cpus)
+      if (c < CPU_SETSIZE)
+          CPU_SET(c, &mask);
+
+  sched_setaffinity(0, sizeof(mask), &mask);
+}
+
+#elif !defined(_WIN32)
 
 void bindThisThread(size_t) {}
 
@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <chrono>
+#include <new>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -33,11 +34,24 @@ namespace Stockfish {
 std::string engine_info(bool to_uci = false);
 std::string compiler_info();
 void prefetch(void* addr);
+
+/// spin_pause() hints to the CPU that we are in a spin-wait loop, lowering
+/// power draw and yielding pipeline resources to a sibling hyperthread.
+inline void spin_pause() {
+
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__ ("yield");
+#endif
+}
 void start_logger(const std::string& fname);
 void* std_aligned_alloc(size_t alignment, size_t size);
 void std_aligned_free(void* ptr);
 void* aligned_large_pages_alloc(size_t size); // memory aligned by page size, min alignment: 4096 bytes
 void aligned_large_pages_free(void* mem); // nop if mem == nullptr
+size_t large_page_size(const void* mem); // explicit huge page size backing mem, 0 if best effort
+void numa_interleave(void* mem, size_t size); // interleave backing pages across NUMA nodes
 
 void dbg_hit_on(bool b);
 void dbg_hit_on(bool c, bool b);
@@ -60,6 +74,36 @@ private:
 };
 
 
+/// SharedHashTable is a runtime-sized variant of HashTable meant to be shared
+/// by all search threads. Probing is lock-free and unsynchronized: entries are
+/// idempotent functions of their key, so like the transposition table a racy
+/// write can at worst produce a torn entry whose effect is a rare, bounded
+/// evaluation error, never a crash. An empty table means the feature is off.
+
+template<class Entry>
+struct SharedHashTable {
+
+  void resize(size_t entryCount) {
+
+    size_t size = 1;
+    while (size * 2 <= entryCount)
+        size *= 2;
+
+    table.clear();
+    if (entryCount)
+        table.resize(size);
+    mask = uint32_t(table.size() - 1);
+  }
+
+  bool enabled() const { return !table.empty(); }
+  Entry* operator[](Key key) { return &table[(uint32_t)key & mask]; }
+
+private:
+  std::vector<Entry> table;
+  uint32_t mask = 0;
+};
+
+
 enum SyncCout { IO_LOCK, IO_UNLOCK };
 std::ostream& operator<<(std::ostream&, SyncCout);
 
@@ -85,6 +129,103 @@ static inline const union { uint32_t i; char c[4]; } Le = { 0x01020304 };
 static inline const bool IsLittleEndian = (Le.c[0] == 4);
 
 
+// FreeListAllocator is a standard allocator that recycles blocks through
+// per-thread free lists instead of returning them to the heap. Node-based
+// containers like std::deque request the same few block sizes over and over,
+// so after warm-up the hot command path never touches the system allocator.
+// Blocks are kept on the list of the thread that freed them; lists are capped
+// so that a burst cannot pin memory forever.
+
+template <typename T>
+class FreeListAllocator {
+
+  struct FreeBlock { FreeBlock* next; std::size_t n; };
+
+  static constexpr std::size_t MaxBlocks = 64;
+
+  static inline thread_local FreeBlock* freeList = nullptr;
+  static inline thread_local std::size_t freeCount = 0;
+
+public:
+  using value_type = T;
+
+  FreeListAllocator() = default;
+  template <typename U> FreeListAllocator(const FreeListAllocator<U>&) {}
+
+  T* allocate(std::size_t n) {
+
+    if (n * sizeof(T) >= sizeof(FreeBlock))
+        for (FreeBlock** b = &freeList; *b; b = &(*b)->next)
+            if ((*b)->n == n)
+            {
+                FreeBlock* hit = *b;
+                *b = hit->next;
+                freeCount--;
+                return reinterpret_cast<T*>(hit);
+            }
+
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) {
+
+    if (n * sizeof(T) >= sizeof(FreeBlock) && freeCount < MaxBlocks)
+    {
+        FreeBlock* b = reinterpret_cast<FreeBlock*>(p);
+        b->next = freeList;
+        b->n = n;
+        freeList = b;
+        freeCount++;
+    }
+    else
+        ::operator delete(p);
+  }
+
+  bool operator==(const FreeListAllocator&) const { return true; }
+  bool operator!=(const FreeListAllocator&) const { return false; }
+};
+
+
+// PerfEventGroup wraps a small fixed set of hardware performance counters
+// (cycles, L1D misses, LLC misses, branch misses) sampled via perf_event_open()
+// on Linux. Counters are inherited by threads spawned after start(), so they
+// must be armed before the search threads are (re)created. On platforms or
+// setups where the counters are unavailable, start() returns false and the
+// group stays inert.
+
+class PerfEventGroup {
+public:
+  ~PerfEventGroup() { stop(); }
+  bool start();
+  void stop();
+
+  uint64_t cycles = 0, l1dMisses = 0, llcMisses = 0, branchMisses = 0;
+
+private:
+  int fds[4] = { -1, -1, -1, -1 };
+};
+
+
+// The Telemetry namespace exports a few live search counters through a small
+// mmap'd file, so an external agent can sample many engine instances without
+// parsing info strings. The block is published with a seqlock: the sequence
+// field is odd while an update is in flight, and a reader retries whenever
+// the sequence changed under it or was odd. Writes happen on the main search
+// thread only, at check_time() cadence. Disabled (all no-ops) until open()
+// is given a file name, and on platforms without mmap support.
+
+namespace Telemetry {
+
+  void open(const std::string& fname);
+  void close();
+
+  // due() rate-limits publishing; it returns false when telemetry is off
+  bool due(TimePoint elapsed);
+  void publish(uint64_t nodes, uint64_t tbHits, int hashfull,
+               int depth, TimePoint elapsed);
+}
+
+
 template <typename T>
 class ValueListInserter {
 public:
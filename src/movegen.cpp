@@ -220,6 +220,87 @@ namespace {
     return moveList;
   }
 
+
+  template<Color Us>
+  ExtMove* generate_captures_of(const Position& pos, ExtMove* moveList, PieceType victim,
+                                Bitboard targets) {
+
+    constexpr Color     Them     = ~Us;
+    constexpr Direction Up       = pawn_push(Us);
+    constexpr Bitboard  TRank7BB = (Us == WHITE ? Rank7BB : Rank2BB);
+
+    Bitboard victims = pos.pieces(Them, victim) & targets;
+
+    while (victims)
+    {
+        Square to = pop_lsb(victims);
+        Bitboard attackers = pos.attackers_to(to) & pos.pieces(Us);
+
+        while (attackers)
+        {
+            Square from = pop_lsb(attackers);
+
+            if (type_of(pos.piece_on(from)) == PAWN && (TRank7BB & from))
+                *moveList++ = make<PROMOTION>(from, to, QUEEN);
+            else
+                *moveList++ = make_move(from, to);
+        }
+    }
+
+    // Queen push promotions and en passant complete the capture set
+    if (victim == PAWN)
+    {
+        Bitboard b = shift<Up>(pos.pieces(Us, PAWN) & TRank7BB) & ~pos.pieces();
+
+        while (b)
+        {
+            Square to = pop_lsb(b);
+            *moveList++ = make<PROMOTION>(to - Up, to, QUEEN);
+        }
+
+        if (pos.ep_square() != SQ_NONE)
+        {
+            b = pos.pieces(Us, PAWN) & ~TRank7BB & pawn_attacks_bb(Them, pos.ep_square());
+
+            while (b)
+                *moveList++ = make<EN_PASSANT>(pop_lsb(b), pos.ep_square());
+        }
+    }
+
+    return moveList;
+  }
+
+
+  template<Color Us>
+  ExtMove* generate_quiets_of(const Position& pos, ExtMove* moveList, PieceType pt) {
+
+    const Bitboard target = ~pos.pieces();
+
+    if (pt == PAWN)
+        return generate_pawn_moves<Us, QUIETS>(pos, moveList, target);
+
+    if (pt == KING)
+    {
+        Square ksq = pos.square<KING>(Us);
+        Bitboard b = attacks_bb<KING>(ksq) & target;
+
+        while (b)
+            *moveList++ = make_move(ksq, pop_lsb(b));
+
+        if (pos.can_castle(Us & ANY_CASTLING))
+            for (CastlingRights cr : { Us & KING_SIDE, Us & QUEEN_SIDE } )
+                if (!pos.castling_impeded(cr) && pos.can_castle(cr))
+                    *moveList++ = make<CASTLING>(ksq, pos.castling_rook_square(cr));
+
+        return moveList;
+    }
+
+    return pt == KNIGHT ? generate_moves<Us, KNIGHT, false>(pos, moveList, target)
+         : pt == BISHOP ? generate_moves<Us, BISHOP, false>(pos, moveList, target)
+         : pt == ROOK   ? generate_moves<Us,   ROOK, false>(pos, moveList, target)
+                        : generate_moves<Us,  QUEEN, false>(pos, moveList, target);
+  }
+
 } // namespace
 
 
@@ -251,6 +332,40 @@ template ExtMove* generate<QUIET_CHECKS>(const Position&, ExtMove*);
 template ExtMove* generate<NON_EVASIONS>(const Position&, ExtMove*);
 
 
+/// generate_next_captures() produces the captures of one victim piece type,
+/// most valuable victims first; the last batch also contains queen push
+/// promotions and en passant. Victims outside the passed mask are never
+/// materialized, which lets the qsearch MovePicker delta-prune whole victim
+/// classes at generation; the promotions and en passant of the last batch
+/// ignore the mask. generate_next_quiets() produces the quiet moves of one
+/// moving piece type; the pawn batch also contains underpromotions and the
+/// king batch castling. Together the batches of each function cover exactly
+/// the moves of generate<CAPTURES> and generate<QUIETS> respectively.
+
+ExtMove* generate_next_captures(const Position& pos, ExtMove* moveList, int batch,
+                                Bitboard victims) {
+
+  assert(!pos.checkers());
+  assert(batch >= 0 && batch < CAPTURE_BATCHES);
+
+  constexpr PieceType Victims[CAPTURE_BATCHES] = { QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
+
+  return pos.side_to_move() == WHITE ? generate_captures_of<WHITE>(pos, moveList, Victims[batch], victims)
+                                     : generate_captures_of<BLACK>(pos, moveList, Victims[batch], victims);
+}
+
+ExtMove* generate_next_quiets(const Position& pos, ExtMove* moveList, int batch) {
+
+  assert(!pos.checkers());
+  assert(batch >= 0 && batch < QUIET_BATCHES);
+
+  constexpr PieceType Movers[QUIET_BATCHES] = { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+  return pos.side_to_move() == WHITE ? generate_quiets_of<WHITE>(pos, moveList, Movers[batch])
+                                     : generate_quiets_of<BLACK>(pos, moveList, Movers[batch]);
+}
+
+
 /// generate<LEGAL> generates all the legal moves in the given position
 
 template<>
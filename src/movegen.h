@@ -55,6 +55,19 @@ inline bool operator<(const ExtMove& f, const ExtMove& s) {
 template<GenType>
 ExtMove* generate(const Position& pos, ExtMove* moveList);
 
+/// Incremental generation for MovePicker: captures are produced in batches,
+/// one victim piece type at a time in descending value order, and quiets one
+/// moving piece type at a time, so a caller that gets an early cutoff never
+/// pays for materializing and scoring the full list. The batches numbered
+/// 0 .. *_BATCHES-1 partition the moves of the corresponding GenType.
+
+constexpr int CAPTURE_BATCHES = 5;
+constexpr int QUIET_BATCHES   = 6;
+
+ExtMove* generate_next_captures(const Position& pos, ExtMove* moveList, int batch,
+                                Bitboard victims = ~Bitboard(0));
+ExtMove* generate_next_quiets(const Position& pos, ExtMove* moveList, int batch);
+
 /// The MoveList struct is a simple wrapper around generate(). It sometimes comes
 /// in handy to use this class instead of the low level generate() function.
 template<GenType T>
@@ -57,23 +57,43 @@ namespace {
 
 /// MovePicker constructor for the main search
 MovePicker::MovePicker(const Position& p, Move ttm, Depth d, const ButterflyHistory* mh, const LowPlyHistory* lp,
-                       const CapturePieceToHistory* cph, const PieceToHistory** ch, Move cm, const Move* killers, int pl)
-           : pos(p), mainHistory(mh), lowPlyHistory(lp), captureHistory(cph), continuationHistory(ch),
+                       const CapturePieceToHistory* cph, const PieceToHistory** ch, Move cm, const Move* killers, int pl,
+                       SEECache* sc)
+           : pos(p), mainHistory(mh), lowPlyHistory(lp), captureHistory(cph), continuationHistory(ch), seeCache(sc),
              ttMove(ttm), refutations{{killers[0], 0}, {killers[1], 0}, {cm, 0}}, depth(d), ply(pl) {
 
   assert(d > 0);
 
+  // The continuation history planes will be probed for every scored quiet,
+  // so start pulling their first lines into cache right away.
+  for (int i : {0, 1, 3, 5})
+      prefetch(const_cast<PieceToHistory*>(continuationHistory[i]));
+
   stage = (pos.checkers() ? EVASION_TT : MAIN_TT) +
           !(ttm && pos.pseudo_legal(ttm));
 }
 
-/// MovePicker constructor for quiescence search
+/// MovePicker constructor for quiescence search. Captures whose victim is
+/// worth no more than 'victimFloor' cannot lift the futility bound above
+/// alpha, so whole victim classes below the floor are delta-pruned at
+/// generation and never materialized or scored. Victims on the promotion
+/// rank are kept: capturing them promotes, which futility pruning exempts.
 MovePicker::MovePicker(const Position& p, Move ttm, Depth d, const ButterflyHistory* mh,
-                       const CapturePieceToHistory* cph, const PieceToHistory** ch, Square rs)
+                       const CapturePieceToHistory* cph, const PieceToHistory** ch, Square rs,
+                       Value victimFloor)
            : pos(p), mainHistory(mh), captureHistory(cph), continuationHistory(ch), ttMove(ttm), recaptureSquare(rs), depth(d) {
 
   assert(d <= 0);
 
+  if (!pos.checkers() && victimFloor > VALUE_ZERO)
+  {
+      for (PieceType pt : { PAWN, KNIGHT, BISHOP, ROOK, QUEEN })
+          if (PieceValue[EG][pt] <= victimFloor)
+              victimMask &= ~pos.pieces(~pos.side_to_move(), pt);
+
+      victimMask |= pos.side_to_move() == WHITE ? Rank8BB : Rank1BB;
+  }
+
   stage = (pos.checkers() ? EVASION_TT : QSEARCH_TT) +
           !(   ttm
             && (pos.checkers() || depth > DEPTH_QS_RECAPTURES || to_sq(ttm) == recaptureSquare)
@@ -100,19 +120,59 @@ void MovePicker::score() {
 
   static_assert(Type == CAPTURES || Type == QUIETS || Type == EVASIONS, "Wrong type");
 
+  // Quiets are scored blockwise: the history entries of a whole block are
+  // prefetched and gathered into contiguous arrays first, then summed in a
+  // separate pass which the compiler can vectorize. This overlaps the cache
+  // misses of the scattered table loads instead of chaining them per move.
+  if constexpr (Type == QUIETS)
+  {
+      constexpr int BlockSize = 32;
+
+      const Color us = pos.side_to_move();
+      const int lphMult = ply < MAX_LPH ? std::min(4, depth / 3) : 0;
+
+      for (ExtMove* b = cur; b < endMoves; b += BlockSize)
+      {
+          const int n = std::min(int(endMoves - b), BlockSize);
+          int16_t h[6][BlockSize];
+
+          for (int i = 0; i < n; ++i)
+          {
+              prefetch(const_cast<void*>(static_cast<const void*>(&(*mainHistory)[us][from_to(b[i])])));
+              prefetch(const_cast<void*>(static_cast<const void*>(&(*continuationHistory[0])[pos.moved_piece(b[i])][to_sq(b[i])])));
+          }
+
+          for (int i = 0; i < n; ++i)
+          {
+              const Move m = b[i];
+              const Piece pc = pos.moved_piece(m);
+              const Square to = to_sq(m);
+
+              h[0][i] = (*mainHistory)[us][from_to(m)];
+              h[1][i] = (*continuationHistory[0])[pc][to];
+              h[2][i] = (*continuationHistory[1])[pc][to];
+              h[3][i] = (*continuationHistory[3])[pc][to];
+              h[4][i] = (*continuationHistory[5])[pc][to];
+              h[5][i] = lphMult ? (*lowPlyHistory)[ply][from_to(m)] : 0;
+          }
+
+          for (int i = 0; i < n; ++i)
+              b[i].value =      h[0][i]
+                          + 2 * h[1][i]
+                          +     h[2][i]
+                          +     h[3][i]
+                          +     h[4][i]
+                          + lphMult * h[5][i];
+      }
+
+      return;
+  }
+
   for (auto& m : *this)
       if constexpr (Type == CAPTURES)
           m.value =  int(PieceValue[MG][pos.piece_on(to_sq(m))]) * 6
                    + (*captureHistory)[pos.moved_piece(m)][to_sq(m)][type_of(pos.piece_on(to_sq(m)))];
 
-      else if constexpr (Type == QUIETS)
-          m.value =      (*mainHistory)[pos.side_to_move()][from_to(m)]
-                   + 2 * (*continuationHistory[0])[pos.moved_piece(m)][to_sq(m)]
-                   +     (*continuationHistory[1])[pos.moved_piece(m)][to_sq(m)]
-                   +     (*continuationHistory[3])[pos.moved_piece(m)][to_sq(m)]
-                   +     (*continuationHistory[5])[pos.moved_piece(m)][to_sq(m)]
-                   + (ply < MAX_LPH ? std::min(4, depth / 3) * (*lowPlyHistory)[ply][from_to(m)] : 0);
-
       else // Type == EVASIONS
       {
           if (pos.capture(m))
@@ -125,6 +185,46 @@ void MovePicker::score() {
       }
 }
 
+/// MovePicker::refill_captures() appends the next non-empty batch of captures
+/// (most valuable victims first) to the move list and scores it. Similarly,
+/// refill_quiets() appends, scores and sorts the quiet moves of the next piece
+/// type. Both are called with the current pool exhausted (cur == endMoves), so
+/// scoring only ever touches the new batch, and both return false once all
+/// batches have been generated.
+
+bool MovePicker::refill_captures() {
+
+  while (genBatch < CAPTURE_BATCHES)
+  {
+      ExtMove* batchEnd = generate_next_captures(pos, endMoves, genBatch++, victimMask);
+
+      if (batchEnd != endMoves)
+      {
+          endMoves = batchEnd;
+          score<CAPTURES>();
+          return true;
+      }
+  }
+  return false;
+}
+
+bool MovePicker::refill_quiets() {
+
+  while (genBatch < QUIET_BATCHES)
+  {
+      ExtMove* batchEnd = generate_next_quiets(pos, endMoves, genBatch++);
+
+      if (batchEnd != endMoves)
+      {
+          endMoves = batchEnd;
+          score<QUIETS>();
+          partial_insertion_sort(cur, endMoves, -3000 * depth);
+          return true;
+      }
+  }
+  return false;
+}
+
 /// MovePicker::select() returns the next move satisfying a predicate function.
 /// It never returns the TT move.
 template<MovePicker::PickType T, typename Pred>
@@ -161,19 +261,24 @@ top:
   case CAPTURE_INIT:
   case PROBCUT_INIT:
   case QCAPTURE_INIT:
-      cur = endBadCaptures = moves;
-      endMoves = generate<CAPTURES>(pos, cur);
-
-      score<CAPTURES>();
+      cur = endBadCaptures = endMoves = moves;
+      genBatch = 0;
+      refill_captures();
       ++stage;
       goto top;
 
   case GOOD_CAPTURE:
-      if (select<Best>([&](){
-                       return pos.see_ge(*cur, Value(-69 * cur->value / 1024)) ?
-                              // Move losing capture to endBadCaptures to be tried later
-                              true : (*endBadCaptures++ = *cur, false); }))
-          return *(cur - 1);
+      while (true)
+      {
+          if (select<Best>([&](){
+                           return pos.see_ge(*cur, Value(-69 * cur->value / 1024), *seeCache) ?
+                                  // Move losing capture to endBadCaptures to be tried later
+                                  true : (*endBadCaptures++ = *cur, false); }))
+              return *(cur - 1);
+
+          if (!refill_captures())
+              break;
+      }
 
       // Prepare the pointers to loop over the refutations array
       cur = std::begin(refutations);
@@ -198,22 +303,27 @@ top:
   case QUIET_INIT:
       if (!skipQuiets)
       {
-          cur = endBadCaptures;
-          endMoves = generate<QUIETS>(pos, cur);
-
-          score<QUIETS>();
-          partial_insertion_sort(cur, endMoves, -3000 * depth);
+          cur = endMoves = endBadCaptures;
+          genBatch = 0;
+          refill_quiets();
       }
+      else
+          genBatch = QUIET_BATCHES;
 
       ++stage;
       [[fallthrough]];
 
   case QUIET:
-      if (   !skipQuiets
-          && select<Next>([&](){return   *cur != refutations[0].move
-                                      && *cur != refutations[1].move
-                                      && *cur != refutations[2].move;}))
-          return *(cur - 1);
+      while (!skipQuiets)
+      {
+          if (select<Next>([&](){return   *cur != refutations[0].move
+                                       && *cur != refutations[1].move
+                                       && *cur != refutations[2].move;}))
+              return *(cur - 1);
+
+          if (!refill_quiets())
+              break;
+      }
 
       // Prepare the pointers to loop over the bad captures
       cur = moves;
@@ -237,12 +347,24 @@ top:
       return select<Best>([](){ return true; });
 
   case PROBCUT:
-      return select<Best>([&](){ return pos.see_ge(*cur, threshold); });
+      while (true)
+      {
+          Move m = select<Best>([&](){ return pos.see_ge(*cur, threshold); });
+
+          if (m || !refill_captures())
+              return m;
+      }
 
   case QCAPTURE:
-      if (select<Best>([&](){ return   depth > DEPTH_QS_RECAPTURES
-                                    || to_sq(*cur) == recaptureSquare; }))
-          return *(cur - 1);
+      while (true)
+      {
+          if (select<Best>([&](){ return   depth > DEPTH_QS_RECAPTURES
+                                        || to_sq(*cur) == recaptureSquare; }))
+              return *(cur - 1);
+
+          if (!refill_captures())
+              break;
+      }
 
       // If we did not find any move and we do not try checks, we have finished
       if (depth != DEPTH_QS_CHECKS)
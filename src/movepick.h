@@ -127,19 +127,23 @@ public:
   MovePicker(const Position&, Move, Depth, const ButterflyHistory*,
                                            const CapturePieceToHistory*,
                                            const PieceToHistory**,
-                                           Square);
+                                           Square,
+                                           Value);
   MovePicker(const Position&, Move, Depth, const ButterflyHistory*,
                                            const LowPlyHistory*,
                                            const CapturePieceToHistory*,
                                            const PieceToHistory**,
                                            Move,
                                            const Move*,
-                                           int);
+                                           int,
+                                           SEECache*);
   Move next_move(bool skipQuiets = false);
 
 private:
   template<PickType T, typename Pred> Move select(Pred);
   template<GenType> void score();
+  bool refill_captures();
+  bool refill_quiets();
   ExtMove* begin() { return cur; }
   ExtMove* end() { return endMoves; }
 
@@ -148,9 +152,12 @@ private:
   const LowPlyHistory* lowPlyHistory;
   const CapturePieceToHistory* captureHistory;
   const PieceToHistory** continuationHistory;
+  SEECache* seeCache;
   Move ttMove;
   ExtMove refutations[3], *cur, *endMoves, *endBadCaptures;
   int stage;
+  int genBatch; // Next batch to pull from the incremental generator
+  Bitboard victimMask = AllSquares; // Victim classes worth generating (qsearch)
   Square recaptureSquare;
   Value threshold;
   Depth depth;
@@ -18,12 +18,21 @@
 
 // Code for calculating NNUE evaluation function
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "../evaluate.h"
 #include "../position.h"
 #include "../misc.h"
@@ -40,10 +49,73 @@ namespace Stockfish::Eval::NNUE {
   // Evaluation function
   AlignedPtr<Network> network[LayerStacks];
 
+  // Active parameter views used by evaluate(): normally they point at the
+  // owned objects above, but with a mapped network file they point straight
+  // into the read-only mapping and the owned objects are released.
+  const FeatureTransformer* ftView = nullptr;
+  const Network* networkView[LayerStacks] = {};
+  void* netMapping = nullptr;
+  size_t netMappingSize = 0;
+
   // Evaluation function file name
   std::string fileName;
   std::string netDescription;
 
+  namespace {
+
+  // On-disk header of a mapped network file, as written by save_mapped_eval().
+  // The file stores the network in its in-memory representation, after all the
+  // architecture-specific weight reordering done at load time, so it is only
+  // valid for the SIMD layout it was exported with, which ArchId encodes.
+  struct MappedNetHeader {
+    char          magic[8];   // "SFNNMAP" + null byte
+    std::uint32_t version;    // NNUE file version
+    std::uint32_t hashValue;  // Network architecture hash
+    std::uint32_t archId;     // SIMD layout the weights were prepared for
+    std::uint32_t descLen;    // Length of the description string that follows
+    std::uint64_t ftOffset;   // File offset of the FeatureTransformer blob
+    std::uint64_t netOffset;  // File offset of the first Network blob
+  };
+
+  constexpr char MappedNetMagic[8] = { 'S', 'F', 'N', 'N', 'M', 'A', 'P', 0 };
+
+  constexpr std::uint32_t ArchId = 0
+#if defined(USE_AVX512)
+      | 1
+#endif
+#if defined(USE_AVX2)
+      | 2
+#endif
+#if defined(USE_SSSE3)
+      | 4
+#endif
+#if defined(USE_SSE2)
+      | 8
+#endif
+#if defined(USE_MMX)
+      | 16
+#endif
+#if defined(USE_NEON)
+      | 32
+#endif
+      ;
+
+  // Blob offsets are page-aligned so that the mapped objects satisfy the
+  // same alignment requirements as the regular allocations.
+  constexpr size_t page_align(size_t n) { return (n + 0xFFF) & ~size_t(0xFFF); }
+
+  void release_mapping() {
+
+#if !defined(_WIN32)
+    if (netMapping)
+        munmap(netMapping, netMappingSize);
+#endif
+    netMapping = nullptr;
+    netMappingSize = 0;
+  }
+
+  }  // anonymous namespace
+
   namespace Detail {
 
   // Initialize the evaluation function parameters
@@ -85,9 +157,16 @@ namespace Stockfish::Eval::NNUE {
   // Initialize the evaluation function parameters
   void initialize() {
 
+    release_mapping();
+
     Detail::initialize(featureTransformer);
+    ftView = featureTransformer.get();
+
     for (std::size_t i = 0; i < LayerStacks; ++i)
+    {
       Detail::initialize(network[i]);
+      networkView[i] = network[i].get();
+    }
   }
 
   // Read network header
@@ -130,9 +209,9 @@ namespace Stockfish::Eval::NNUE {
   bool write_parameters(std::ostream& stream) {
 
     if (!write_header(stream, HashValue, netDescription)) return false;
-    if (!Detail::write_parameters(stream, *featureTransformer)) return false;
+    if (!Detail::write_parameters(stream, *ftView)) return false;
     for (std::size_t i = 0; i < LayerStacks; ++i)
-      if (!Detail::write_parameters(stream, *(network[i]))) return false;
+      if (!Detail::write_parameters(stream, *networkView[i])) return false;
     return (bool)stream;
   }
 
@@ -161,8 +240,8 @@ namespace Stockfish::Eval::NNUE {
     ASSERT_ALIGNED(buffer, alignment);
 
     const std::size_t bucket = (pos.count<ALL_PIECES>() - 1) / 4;
-    const auto psqt = featureTransformer->transform(pos, transformedFeatures, bucket);
-    const auto output = network[bucket]->propagate(transformedFeatures, buffer);
+    const auto psqt = ftView->transform(pos, transformedFeatures, bucket);
+    const auto output = networkView[bucket]->propagate(transformedFeatures, buffer);
 
     int materialist = psqt;
     int positional  = output[0];
@@ -178,6 +257,130 @@ namespace Stockfish::Eval::NNUE {
     return static_cast<Value>( sum / OutputScale );
   }
 
+  // benchmark() times the forward pass kernel by kernel over a fixed position
+  // set, so that compiler flag or SIMD changes can be attributed to the layer
+  // they affect without search noise. The feature transform is measured twice,
+  // once with a forced accumulator refresh and once with the accumulator
+  // cached (only the clip-and-copy output pass runs, the steady-state cost
+  // during search). Per-layer numbers are obtained by propagating every
+  // prefix of the layer stack and differencing the cumulative timings, which
+  // keeps the layers' propagate() code paths exactly as evaluate() runs them.
+  // All outputs are folded into a checksum so nothing is optimized away.
+  void benchmark(const std::vector<Position*>& positions, int iterations) {
+
+    if (!ftView || positions.empty() || iterations <= 0)
+        return;
+
+    constexpr uint64_t alignment = CacheLineSize;
+
+#if defined(ALIGNAS_ON_STACK_VARIABLES_BROKEN)
+    TransformedFeatureType transformedFeaturesUnaligned[
+      FeatureTransformer::BufferSize + alignment / sizeof(TransformedFeatureType)];
+    char bufferUnaligned[Network::BufferSize + alignment];
+
+    auto* transformedFeatures = align_ptr_up<alignment>(&transformedFeaturesUnaligned[0]);
+    auto* buffer = align_ptr_up<alignment>(&bufferUnaligned[0]);
+#else
+    alignas(alignment)
+      TransformedFeatureType transformedFeatures[FeatureTransformer::BufferSize];
+    alignas(alignment) char buffer[Network::BufferSize];
+#endif
+
+    ASSERT_ALIGNED(transformedFeatures, alignment);
+    ASSERT_ALIGNED(buffer, alignment);
+
+    const int64_t evals = int64_t(iterations) * positions.size();
+    std::uint64_t sink = 0;
+
+    auto bucket_of = [](const Position& pos) {
+        return std::size_t(pos.count<ALL_PIECES>() - 1) / 4;
+    };
+
+    // Run a kernel over the whole position set for the given number of
+    // iterations and return the elapsed time in nanoseconds
+    auto time_ns = [&](auto&& kernel) {
+        auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            for (Position* pos : positions)
+                kernel(*pos);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - started).count();
+    };
+
+    auto report = [&](const char* name, int64_t ns) {
+        sync_cout << std::left  << std::setw(36) << name
+                  << std::right << std::setw(8)  << (ns + evals / 2) / evals << " ns/eval"
+                  << std::setw(14) << (ns ? evals * 1000000000 / ns : 0) << " evals/s"
+                  << sync_endl;
+    };
+
+    int64_t tRefresh = time_ns([&](Position& pos) {
+        StateInfo* st = pos.state();
+        st->accumulator->computed[WHITE] = st->accumulator->computed[BLACK] = false;
+        sink += ftView->transform(pos, transformedFeatures, bucket_of(pos));
+    });
+
+    int64_t tTransform = time_ns([&](Position& pos) {
+        sink += ftView->transform(pos, transformedFeatures, bucket_of(pos));
+    });
+
+    // Cumulative times of the layer stack prefixes. The InputSlice layer just
+    // returns a pointer into the transformed features and is counted with the
+    // first affine layer.
+    int64_t cum[5];
+
+    cum[0] = time_ns([&](Position& pos) {
+        sink += networkView[bucket_of(pos)]->previous_layer().previous_layer()
+                    .previous_layer().previous_layer()
+                    .propagate(transformedFeatures, buffer)[0];
+    });
+    cum[1] = time_ns([&](Position& pos) {
+        sink += networkView[bucket_of(pos)]->previous_layer().previous_layer()
+                    .previous_layer().propagate(transformedFeatures, buffer)[0];
+    });
+    cum[2] = time_ns([&](Position& pos) {
+        sink += networkView[bucket_of(pos)]->previous_layer().previous_layer()
+                    .propagate(transformedFeatures, buffer)[0];
+    });
+    cum[3] = time_ns([&](Position& pos) {
+        sink += networkView[bucket_of(pos)]->previous_layer()
+                    .propagate(transformedFeatures, buffer)[0];
+    });
+    cum[4] = time_ns([&](Position& pos) {
+        sink += networkView[bucket_of(pos)]->propagate(transformedFeatures, buffer)[0];
+    });
+
+    int64_t tEvaluate = time_ns([&](Position& pos) { sink += evaluate(pos); });
+
+    using Affine1 = std::remove_reference_t<decltype(
+        networkView[0]->previous_layer().previous_layer().previous_layer().previous_layer())>;
+    using Affine2 = std::remove_reference_t<decltype(
+        networkView[0]->previous_layer().previous_layer())>;
+
+    sync_cout << "Position set: " << positions.size() << " positions, "
+              << iterations << " iterations, net '" << fileName << "'" << sync_endl;
+
+    report("accumulator refresh + transform", tRefresh);
+    report("feature transform (cached acc.)", tTransform);
+
+    char name[64];
+    sprintf(name, "affine %u -> %u", Affine1::InputDimensions, Affine1::OutputDimensions);
+    report(name, cum[0]);
+    sprintf(name, "clipped_relu %u", Affine1::OutputDimensions);
+    report(name, std::max<int64_t>(cum[1] - cum[0], 0));
+    sprintf(name, "affine %u -> %u", Affine2::InputDimensions, Affine2::OutputDimensions);
+    report(name, std::max<int64_t>(cum[2] - cum[1], 0));
+    sprintf(name, "clipped_relu %u", Affine2::OutputDimensions);
+    report(name, std::max<int64_t>(cum[3] - cum[2], 0));
+    sprintf(name, "affine %u -> %u", Network::InputDimensions, Network::OutputDimensions);
+    report(name, std::max<int64_t>(cum[4] - cum[3], 0));
+
+    report("full forward pass", cum[4] + tTransform);
+    report("NNUE::evaluate()", tEvaluate);
+
+    sync_cout << "checksum " << sink << sync_endl;
+  }
+
   struct NnueEvalTrace {
     static_assert(LayerStacks == PSQTBuckets);
 
@@ -212,8 +415,8 @@ namespace Stockfish::Eval::NNUE {
     NnueEvalTrace t{};
     t.correctBucket = (pos.count<ALL_PIECES>() - 1) / 4;
     for (std::size_t bucket = 0; bucket < LayerStacks; ++bucket) {
-      const auto psqt = featureTransformer->transform(pos, transformedFeatures, bucket);
-      const auto output = network[bucket]->propagate(transformedFeatures, buffer);
+      const auto psqt = ftView->transform(pos, transformedFeatures, bucket);
+      const auto output = networkView[bucket]->propagate(transformedFeatures, buffer);
 
       int materialist = psqt;
       int positional  = output[0];
@@ -315,16 +518,16 @@ namespace Stockfish::Eval::NNUE {
           auto st = pos.state();
 
           pos.remove_piece(sq);
-          st->accumulator.computed[WHITE] = false;
-          st->accumulator.computed[BLACK] = false;
+          st->accumulator->computed[WHITE] = false;
+          st->accumulator->computed[BLACK] = false;
 
           Value eval = evaluate(pos);
           eval = pos.side_to_move() == WHITE ? eval : -eval;
           v = base - eval;
 
           pos.put_piece(pc, sq);
-          st->accumulator.computed[WHITE] = false;
-          st->accumulator.computed[BLACK] = false;
+          st->accumulator->computed[WHITE] = false;
+          st->accumulator->computed[BLACK] = false;
         }
 
         writeSquare(f, r, pc, v);
@@ -377,6 +580,114 @@ namespace Stockfish::Eval::NNUE {
     return read_parameters(stream);
   }
 
+  // Load eval from a mapped network file written by save_mapped_eval(). The
+  // file is mapped read-only and shared, so any number of engine processes on
+  // the host reference one physical copy of the weights, and startup touches
+  // no page until the search does. Returns false, leaving the current network
+  // untouched, if the file does not exist, is not in the mapped format, or
+  // was prepared for a different architecture or SIMD layout.
+  bool load_mapped_eval(const std::string& path) {
+
+#if !defined(_WIN32)
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0)
+        return ::close(fd), false;
+
+    void* mem = mmap(nullptr, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mem == MAP_FAILED)
+        return false;
+
+    const char* base = static_cast<const char*>(mem);
+    const auto* header = reinterpret_cast<const MappedNetHeader*>(base);
+
+    if (   size_t(sb.st_size) < sizeof(MappedNetHeader)
+        || std::memcmp(header->magic, MappedNetMagic, sizeof(header->magic)) != 0
+        || header->version != Version
+        || header->hashValue != HashValue
+        || header->archId != ArchId
+        || sizeof(MappedNetHeader) + header->descLen > header->ftOffset
+        || header->ftOffset + page_align(sizeof(FeatureTransformer)) != header->netOffset
+        || size_t(sb.st_size) != header->netOffset + LayerStacks * page_align(sizeof(Network)))
+    {
+        munmap(mem, sb.st_size);
+        return false;
+    }
+
+    // Release the owned copies and point the views into the mapping
+    featureTransformer.reset();
+    for (std::size_t i = 0; i < LayerStacks; ++i)
+      network[i].reset();
+    release_mapping();
+
+    netMapping = mem;
+    netMappingSize = size_t(sb.st_size);
+
+    ftView = reinterpret_cast<const FeatureTransformer*>(base + header->ftOffset);
+    for (std::size_t i = 0; i < LayerStacks; ++i)
+      networkView[i] = reinterpret_cast<const Network*>(base + header->netOffset
+                                                            + i * page_align(sizeof(Network)));
+
+    netDescription.assign(base + sizeof(MappedNetHeader), header->descLen);
+    fileName = path;
+
+    return true;
+
+#else
+
+    (void)path; // Zero-copy sharing needs mmap, regular loading covers Windows
+    return false;
+
+#endif
+  }
+
+  // Save eval in the mapped format: a small header, the description, then the
+  // raw in-memory FeatureTransformer and Network objects at page-aligned
+  // offsets, ready to be mapped back by load_mapped_eval()
+  bool save_mapped_eval(const std::string& path) {
+
+    if (eval_file_loaded == "None")
+        return false;
+
+    MappedNetHeader header = {};
+    std::memcpy(header.magic, MappedNetMagic, sizeof(header.magic));
+    header.version   = Version;
+    header.hashValue = HashValue;
+    header.archId    = ArchId;
+    header.descLen   = std::uint32_t(netDescription.size());
+    header.ftOffset  = page_align(sizeof(header) + netDescription.size());
+    header.netOffset = header.ftOffset + page_align(sizeof(FeatureTransformer));
+
+    std::ofstream stream(path, std::ios::binary);
+
+    if (!stream)
+        return false;
+
+    auto write_padded = [&stream](const void* data, size_t size) {
+        stream.write(static_cast<const char*>(data), size);
+        for (size_t i = size; i < page_align(size); ++i)
+            stream.put(0);
+    };
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(netDescription.data(), netDescription.size());
+    for (size_t i = sizeof(header) + netDescription.size(); i < header.ftOffset; ++i)
+        stream.put(0);
+
+    write_padded(ftView, sizeof(FeatureTransformer));
+    for (std::size_t i = 0; i < LayerStacks; ++i)
+        write_padded(networkView[i], sizeof(Network));
+
+    return bool(stream);
+  }
+
   // Save eval, to a file stream or a memory stream
   bool save_eval(std::ostream& stream) {
 
@@ -50,6 +50,36 @@ namespace Stockfish::Eval::NNUE::Features {
   }
 
 
+  // append_refresh_indices() : get lists of indices that differ between the
+  // position and a cached piece placement with the same king square
+
+  void HalfKAv2::append_refresh_indices(
+    const Position& pos,
+    Color perspective,
+    const Bitboard* byColorBB,
+    const Bitboard* byTypeBB,
+    ValueListInserter<IndexType> removed,
+    ValueListInserter<IndexType> added
+  ) {
+    Square ksq = orient(perspective, pos.square<KING>(perspective));
+    for (Color c : { WHITE, BLACK })
+        for (PieceType pt = PAWN; pt <= KING; ++pt)
+        {
+            const Piece pc = make_piece(c, pt);
+            const Bitboard oldBB = byColorBB[c] & byTypeBB[pt];
+            const Bitboard newBB = pos.pieces(c, pt);
+
+            Bitboard rem = oldBB & ~newBB;
+            while (rem)
+                removed.push_back(make_index(perspective, pop_lsb(rem), pc, ksq));
+
+            Bitboard add = newBB & ~oldBB;
+            while (add)
+                added.push_back(make_index(perspective, pop_lsb(add), pc, ksq));
+        }
+  }
+
+
   // append_changed_indices() : get a list of indices for recently changed features
 
   void HalfKAv2::append_changed_indices(
@@ -88,6 +88,16 @@ namespace Stockfish::Eval::NNUE::Features {
       Color perspective,
       ValueListInserter<IndexType> active);
 
+    // Get lists of indices that differ between the position and a cached
+    // piece placement computed with the king on the same square
+    static void append_refresh_indices(
+      const Position& pos,
+      Color perspective,
+      const Bitboard* byColorBB,
+      const Bitboard* byTypeBB,
+      ValueListInserter<IndexType> removed,
+      ValueListInserter<IndexType> added);
+
     // Get a list of indices for recently changed features
     static void append_changed_indices(
       Square ksq,
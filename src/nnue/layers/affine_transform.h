@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include "../nnue_common.h"
+#include "../nnue_simd_dispatch.h"
 
 namespace Stockfish::Eval::NNUE::Layers {
 
@@ -109,6 +110,9 @@ namespace Stockfish::Eval::NNUE::Layers {
       return !stream.fail();
     }
 
+    // Read-only access to the previous layer, for the kernel benchmark
+    const PreviousLayer& previous_layer() const { return previousLayer; }
+
     // Forward propagation
     const OutputType* propagate(
         const TransformedFeatureType* transformedFeatures, char* buffer) const {
@@ -231,6 +235,7 @@ namespace Stockfish::Eval::NNUE::Layers {
       using vec_t = __m512i;
       #define vec_setzero _mm512_setzero_si512
       #define vec_set_32 _mm512_set1_epi32
+      #define vec_add_32 _mm512_add_epi32
       auto& vec_add_dpbusd_32 = m512_add_dpbusd_epi32;
       auto& vec_add_dpbusd_32x4 = m512_add_dpbusd_epi32x4;
       auto& vec_hadd = m512_hadd;
@@ -238,6 +243,7 @@ namespace Stockfish::Eval::NNUE::Layers {
       using vec_t = __m256i;
       #define vec_setzero _mm256_setzero_si256
       #define vec_set_32 _mm256_set1_epi32
+      #define vec_add_32 _mm256_add_epi32
       auto& vec_add_dpbusd_32 = m256_add_dpbusd_epi32;
       auto& vec_add_dpbusd_32x4 = m256_add_dpbusd_epi32x4;
       auto& vec_hadd = m256_hadd;
@@ -245,6 +251,7 @@ namespace Stockfish::Eval::NNUE::Layers {
       using vec_t = __m128i;
       #define vec_setzero _mm_setzero_si128
       #define vec_set_32 _mm_set1_epi32
+      #define vec_add_32 _mm_add_epi32
       auto& vec_add_dpbusd_32 = m128_add_dpbusd_epi32;
       auto& vec_add_dpbusd_32x4 = m128_add_dpbusd_epi32x4;
       auto& vec_hadd = m128_hadd;
@@ -269,6 +276,43 @@ namespace Stockfish::Eval::NNUE::Layers {
           vec_t* outptr = reinterpret_cast<vec_t*>(output);
           std::memcpy(output, biases, OutputDimensions * sizeof(OutputType));
 
+#if defined (USE_VNNI)
+          // vpdpbusd accumulates straight into its destination register, so
+          // issuing all four products of a step into one accumulator would
+          // serialize the loop on the instruction latency. Split the
+          // accumulation over two register sets and fold them once at the end
+          // to expose more instruction-level parallelism.
+          constexpr IndexType NumRegs = OutputDimensions / OutputSimdWidth;
+          vec_t acc0[NumRegs], acc1[NumRegs];
+
+          for (IndexType j = 0; j < NumRegs; ++j)
+          {
+              acc0[j] = outptr[j];
+              acc1[j] = vec_setzero();
+          }
+
+          for (int i = 0; i < (int)NumChunks - 3; i += 4)
+          {
+              const vec_t in0 = vec_set_32(input32[i + 0]);
+              const vec_t in1 = vec_set_32(input32[i + 1]);
+              const vec_t in2 = vec_set_32(input32[i + 2]);
+              const vec_t in3 = vec_set_32(input32[i + 3]);
+              const auto col0 = reinterpret_cast<const vec_t*>(&weights[(i + 0) * OutputDimensions * 4]);
+              const auto col1 = reinterpret_cast<const vec_t*>(&weights[(i + 1) * OutputDimensions * 4]);
+              const auto col2 = reinterpret_cast<const vec_t*>(&weights[(i + 2) * OutputDimensions * 4]);
+              const auto col3 = reinterpret_cast<const vec_t*>(&weights[(i + 3) * OutputDimensions * 4]);
+              for (IndexType j = 0; j < NumRegs; ++j)
+              {
+                  vec_add_dpbusd_32(acc0[j], in0, col0[j]);
+                  vec_add_dpbusd_32(acc0[j], in1, col1[j]);
+                  vec_add_dpbusd_32(acc1[j], in2, col2[j]);
+                  vec_add_dpbusd_32(acc1[j], in3, col3[j]);
+              }
+          }
+
+          for (IndexType j = 0; j < NumRegs; ++j)
+              outptr[j] = vec_add_32(acc0[j], acc1[j]);
+#else
           for (int i = 0; i < (int)NumChunks - 3; i += 4)
           {
               const vec_t in0 = vec_set_32(input32[i + 0]);
@@ -282,6 +326,7 @@ namespace Stockfish::Eval::NNUE::Layers {
               for (int j = 0; j * OutputSimdWidth < OutputDimensions; ++j)
                   vec_add_dpbusd_32x4(outptr[j], in0, col0[j], in1, col1[j], in2, col2[j], in3, col3[j]);
           }
+#endif
       }
       else if constexpr (OutputDimensions == 1)
       {
@@ -327,6 +372,15 @@ namespace Stockfish::Eval::NNUE::Layers {
 
       auto output = reinterpret_cast<OutputType*>(buffer);
 
+      // These builds keep the natural weight ordering, so the
+      // runtime-dispatched kernel can take over on wider hosts.
+      if (Dispatch::Wide)
+      {
+          Dispatch::affine(weights, biases, input, output,
+                           InputDimensions, PaddedInputDimensions, OutputDimensions);
+          return output;
+      }
+
 #if defined(USE_SSE2)
       // At least a multiple of 16, with SSE2.
       static_assert(InputDimensions % SimdWidth == 0);
@@ -22,6 +22,7 @@
 #define NNUE_LAYERS_CLIPPED_RELU_H_INCLUDED
 
 #include "../nnue_common.h"
+#include "../nnue_simd_dispatch.h"
 
 namespace Stockfish::Eval::NNUE::Layers {
 
@@ -64,6 +65,9 @@ namespace Stockfish::Eval::NNUE::Layers {
       return previousLayer.write_parameters(stream);
     }
 
+    // Read-only access to the previous layer, for the kernel benchmark
+    const PreviousLayer& previous_layer() const { return previousLayer; }
+
     // Forward propagation
     const OutputType* propagate(
         const TransformedFeatureType* transformedFeatures, char* buffer) const {
@@ -71,6 +75,12 @@ namespace Stockfish::Eval::NNUE::Layers {
           transformedFeatures, buffer + SelfBufferSize);
       const auto output = reinterpret_cast<OutputType*>(buffer);
 
+      if (Dispatch::Wide)
+      {
+          Dispatch::scale_clip_to_u8(input, output, InputDimensions, WeightScaleBits);
+          return output;
+      }
+
   #if defined(USE_AVX2)
       if constexpr (InputDimensions % SimdWidth == 0) {
         constexpr IndexType NumChunks = InputDimensions / SimdWidth;
@@ -21,8 +21,13 @@
 #ifndef NNUE_ACCUMULATOR_H_INCLUDED
 #define NNUE_ACCUMULATOR_H_INCLUDED
 
+#include <cassert>
+#include <deque>
+
 #include "nnue_architecture.h"
 
+#include "../types.h"
+
 namespace Stockfish::Eval::NNUE {
 
   // Class that holds the result of affine transformation of input features
@@ -32,6 +37,53 @@ namespace Stockfish::Eval::NNUE {
     bool computed[2];
   };
 
+  // AccumulatorPool owns the accumulator storage for the do/undo chain of one
+  // Position. A StateInfo only keeps a pointer into the pool, so the 3KB
+  // accumulator no longer travels inside the same allocation as the per-move
+  // state and the do_move() head copy stays within a cache line or two.
+  // Blocks are handed out in do_move() order and returned in undo_move()
+  // order, which makes the pool a plain stack; the storage is reused across
+  // set() calls and grows lazily to the deepest chain seen. A deque keeps the
+  // block addresses stable while states point at them.
+  class AccumulatorPool {
+  public:
+    Accumulator* push() {
+      if (next == blocks.size())
+          blocks.emplace_back();
+      Accumulator& acc = blocks[next++];
+      acc.computed[WHITE] = acc.computed[BLACK] = false;
+      return &acc;
+    }
+    void pop() { assert(next); --next; }
+    void reset() { next = 0; }
+
+  private:
+    std::deque<Accumulator> blocks;
+    std::size_t next = 0;
+  };
+
+  // AccumulatorRefreshEntry caches the last fully computed accumulator of one
+  // perspective for one king square, together with the piece placement it was
+  // computed from. A later refresh with the king on the same square then only
+  // applies the features that differ from the cached placement instead of
+  // rebuilding the whole accumulator from the biases.
+  struct alignas(CacheLineSize) AccumulatorRefreshEntry {
+    std::int16_t accumulation[TransformedFeatureDimensions];
+    std::int32_t psqtAccumulation[PSQTBuckets];
+    Bitboard byColorBB[COLOR_NB];
+    Bitboard byTypeBB[PIECE_TYPE_NB];
+    bool valid;
+  };
+
+  // AccumulatorRefreshTable (a "finny table") is held per thread and indexed
+  // by perspective and king square. Invalid entries are initialized lazily by
+  // the feature transformer, which owns the biases.
+  struct AccumulatorRefreshTable {
+    AccumulatorRefreshEntry entries[COLOR_NB][SQUARE_NB];
+
+    void clear() { std::memset(entries, 0, sizeof(entries)); }
+  };
+
 }  // namespace Stockfish::Eval::NNUE
 
 #endif // NNUE_ACCUMULATOR_H_INCLUDED
@@ -23,6 +23,9 @@
 
 #include "nnue_common.h"
 #include "nnue_architecture.h"
+#include "nnue_simd_dispatch.h"
+
+#include "../thread.h" // for the per-thread AccumulatorRefreshTable
 
 #include <cstring> // std::memset()
 
@@ -154,8 +157,22 @@ namespace Stockfish::Eval::NNUE {
           return 1;
       }
 
+      // BestRegisterCount() picks the tiling purely from the architectural
+      // register count, but the fastest choice differs between cores with the
+      // same ISA. The 'autotune' Makefile target measures the accumulator
+      // kernels on the build host with every legal candidate and bakes the
+      // winner in through these overrides; an illegal candidate is rejected
+      // by the TileHeight static_asserts below.
+  #if defined(NNUE_NUM_REGS)
+      static constexpr int NumRegs     = NNUE_NUM_REGS;
+  #else
       static constexpr int NumRegs     = BestRegisterCount<vec_t, WeightType, TransformedFeatureDimensions, NumRegistersSIMD>();
+  #endif
+  #if defined(NNUE_NUM_PSQT_REGS)
+      static constexpr int NumPsqtRegs = NNUE_NUM_PSQT_REGS;
+  #else
       static constexpr int NumPsqtRegs = BestRegisterCount<psqt_vec_t, PSQTWeightType, PSQTBuckets, NumRegistersSIMD>();
+  #endif
 
       #pragma GCC diagnostic pop
 
@@ -220,14 +237,23 @@ namespace Stockfish::Eval::NNUE {
       update_accumulator(pos, BLACK);
 
       const Color perspectives[2] = {pos.side_to_move(), ~pos.side_to_move()};
-      const auto& accumulation = pos.state()->accumulator.accumulation;
-      const auto& psqtAccumulation = pos.state()->accumulator.psqtAccumulation;
+      const auto& accumulation = pos.state()->accumulator->accumulation;
+      const auto& psqtAccumulation = pos.state()->accumulator->psqtAccumulation;
 
       const auto psqt = (
             psqtAccumulation[perspectives[0]][bucket]
           - psqtAccumulation[perspectives[1]][bucket]
         ) / 2;
 
+      // On a host wider than the compile-time SIMD level, use the
+      // runtime-dispatched kernel instead of the baked-in path below.
+      if (Dispatch::Wide)
+      {
+          for (IndexType p = 0; p < 2; ++p)
+              Dispatch::clip_to_u8(accumulation[perspectives[p]],
+                                   &output[HalfDimensions * p], HalfDimensions);
+          return psqt;
+      }
 
   #if defined(USE_AVX512)
 
@@ -383,7 +409,7 @@ namespace Stockfish::Eval::NNUE {
       // of the estimated gain in terms of features to be added/subtracted.
       StateInfo *st = pos.state(), *next = nullptr;
       int gain = FeatureSet::refresh_cost(pos);
-      while (st->previous && !st->accumulator.computed[perspective])
+      while (st->previous && !st->accumulator->computed[perspective])
       {
         // This governs when a full feature refresh is needed and how many
         // updates are better than just one full refresh.
@@ -394,7 +420,7 @@ namespace Stockfish::Eval::NNUE {
         st = st->previous;
       }
 
-      if (st->accumulator.computed[perspective])
+      if (st->accumulator->computed[perspective])
       {
         if (next == nullptr)
           return;
@@ -412,44 +438,70 @@ namespace Stockfish::Eval::NNUE {
             ksq, st2, perspective, removed[1], added[1]);
 
         // Mark the accumulators as computed.
-        next->accumulator.computed[perspective] = true;
-        pos.state()->accumulator.computed[perspective] = true;
+        next->accumulator->computed[perspective] = true;
+        pos.state()->accumulator->computed[perspective] = true;
 
         // Now update the accumulators listed in states_to_update[], where the last element is a sentinel.
         StateInfo *states_to_update[3] =
           { next, next == pos.state() ? nullptr : pos.state(), nullptr };
   #ifdef VECTOR
+        if (!Dispatch::Wide)
+        {
+        // Gather the weight rows of all updates up front, so each register
+        // tile below is processed in one fused load/sub/add/store chain and
+        // the row offsets are not recomputed per tile. Captures and castling
+        // contribute 3-4 rows per update and dominate qsearch, so this saves
+        // repeated address arithmetic on every pass over the accumulator.
+        int numSub[2] = {}, numAdd[2] = {};
+        const WeightType*     subColumns[2][FeatureSet::MaxActiveDimensions];
+        const WeightType*     addColumns[2][FeatureSet::MaxActiveDimensions];
+        const PSQTWeightType* subColumnsPsqt[2][FeatureSet::MaxActiveDimensions];
+        const PSQTWeightType* addColumnsPsqt[2][FeatureSet::MaxActiveDimensions];
+
+        for (IndexType i = 0; states_to_update[i]; ++i)
+        {
+          for (const auto index : removed[i])
+          {
+            subColumns[i][numSub[i]] = &weights[HalfDimensions * index];
+            subColumnsPsqt[i][numSub[i]++] = &psqtWeights[PSQTBuckets * index];
+          }
+
+          for (const auto index : added[i])
+          {
+            addColumns[i][numAdd[i]] = &weights[HalfDimensions * index];
+            addColumnsPsqt[i][numAdd[i]++] = &psqtWeights[PSQTBuckets * index];
+          }
+        }
+
         for (IndexType j = 0; j < HalfDimensions / TileHeight; ++j)
         {
           // Load accumulator
           auto accTile = reinterpret_cast<vec_t*>(
-            &st->accumulator.accumulation[perspective][j * TileHeight]);
+            &st->accumulator->accumulation[perspective][j * TileHeight]);
           for (IndexType k = 0; k < NumRegs; ++k)
             acc[k] = vec_load(&accTile[k]);
 
           for (IndexType i = 0; states_to_update[i]; ++i)
           {
             // Difference calculation for the deactivated features
-            for (const auto index : removed[i])
+            for (int n = 0; n < numSub[i]; ++n)
             {
-              const IndexType offset = HalfDimensions * index + j * TileHeight;
-              auto column = reinterpret_cast<const vec_t*>(&weights[offset]);
+              auto column = reinterpret_cast<const vec_t*>(subColumns[i][n] + j * TileHeight);
               for (IndexType k = 0; k < NumRegs; ++k)
                 acc[k] = vec_sub_16(acc[k], column[k]);
             }
 
             // Difference calculation for the activated features
-            for (const auto index : added[i])
+            for (int n = 0; n < numAdd[i]; ++n)
             {
-              const IndexType offset = HalfDimensions * index + j * TileHeight;
-              auto column = reinterpret_cast<const vec_t*>(&weights[offset]);
+              auto column = reinterpret_cast<const vec_t*>(addColumns[i][n] + j * TileHeight);
               for (IndexType k = 0; k < NumRegs; ++k)
                 acc[k] = vec_add_16(acc[k], column[k]);
             }
 
             // Store accumulator
             accTile = reinterpret_cast<vec_t*>(
-              &states_to_update[i]->accumulator.accumulation[perspective][j * TileHeight]);
+              &states_to_update[i]->accumulator->accumulation[perspective][j * TileHeight]);
             for (IndexType k = 0; k < NumRegs; ++k)
               vec_store(&accTile[k], acc[k]);
           }
@@ -459,96 +511,146 @@ namespace Stockfish::Eval::NNUE {
         {
           // Load accumulator
           auto accTilePsqt = reinterpret_cast<psqt_vec_t*>(
-            &st->accumulator.psqtAccumulation[perspective][j * PsqtTileHeight]);
+            &st->accumulator->psqtAccumulation[perspective][j * PsqtTileHeight]);
           for (std::size_t k = 0; k < NumPsqtRegs; ++k)
             psqt[k] = vec_load_psqt(&accTilePsqt[k]);
 
           for (IndexType i = 0; states_to_update[i]; ++i)
           {
             // Difference calculation for the deactivated features
-            for (const auto index : removed[i])
+            for (int n = 0; n < numSub[i]; ++n)
             {
-              const IndexType offset = PSQTBuckets * index + j * PsqtTileHeight;
-              auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(&psqtWeights[offset]);
+              auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(subColumnsPsqt[i][n] + j * PsqtTileHeight);
               for (std::size_t k = 0; k < NumPsqtRegs; ++k)
                 psqt[k] = vec_sub_psqt_32(psqt[k], columnPsqt[k]);
             }
 
             // Difference calculation for the activated features
-            for (const auto index : added[i])
+            for (int n = 0; n < numAdd[i]; ++n)
             {
-              const IndexType offset = PSQTBuckets * index + j * PsqtTileHeight;
-              auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(&psqtWeights[offset]);
+              auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(addColumnsPsqt[i][n] + j * PsqtTileHeight);
               for (std::size_t k = 0; k < NumPsqtRegs; ++k)
                 psqt[k] = vec_add_psqt_32(psqt[k], columnPsqt[k]);
             }
 
             // Store accumulator
             accTilePsqt = reinterpret_cast<psqt_vec_t*>(
-              &states_to_update[i]->accumulator.psqtAccumulation[perspective][j * PsqtTileHeight]);
+              &states_to_update[i]->accumulator->psqtAccumulation[perspective][j * PsqtTileHeight]);
             for (std::size_t k = 0; k < NumPsqtRegs; ++k)
               vec_store_psqt(&accTilePsqt[k], psqt[k]);
           }
         }
-
-  #else
+        }
+        else
+  #endif
         for (IndexType i = 0; states_to_update[i]; ++i)
         {
-          std::memcpy(states_to_update[i]->accumulator.accumulation[perspective],
-              st->accumulator.accumulation[perspective],
+          std::memcpy(states_to_update[i]->accumulator->accumulation[perspective],
+              st->accumulator->accumulation[perspective],
               HalfDimensions * sizeof(BiasType));
 
           for (std::size_t k = 0; k < PSQTBuckets; ++k)
-            states_to_update[i]->accumulator.psqtAccumulation[perspective][k] = st->accumulator.psqtAccumulation[perspective][k];
+            states_to_update[i]->accumulator->psqtAccumulation[perspective][k] = st->accumulator->psqtAccumulation[perspective][k];
 
           st = states_to_update[i];
 
           // Difference calculation for the deactivated features
           for (const auto index : removed[i])
           {
-            const IndexType offset = HalfDimensions * index;
-
-            for (IndexType j = 0; j < HalfDimensions; ++j)
-              st->accumulator.accumulation[perspective][j] -= weights[offset + j];
+            Dispatch::sub_column(st->accumulator->accumulation[perspective],
+                                 &weights[HalfDimensions * index], HalfDimensions);
 
             for (std::size_t k = 0; k < PSQTBuckets; ++k)
-              st->accumulator.psqtAccumulation[perspective][k] -= psqtWeights[index * PSQTBuckets + k];
+              st->accumulator->psqtAccumulation[perspective][k] -= psqtWeights[index * PSQTBuckets + k];
           }
 
           // Difference calculation for the activated features
           for (const auto index : added[i])
           {
-            const IndexType offset = HalfDimensions * index;
-
-            for (IndexType j = 0; j < HalfDimensions; ++j)
-              st->accumulator.accumulation[perspective][j] += weights[offset + j];
+            Dispatch::add_column(st->accumulator->accumulation[perspective],
+                                 &weights[HalfDimensions * index], HalfDimensions);
 
             for (std::size_t k = 0; k < PSQTBuckets; ++k)
-              st->accumulator.psqtAccumulation[perspective][k] += psqtWeights[index * PSQTBuckets + k];
+              st->accumulator->psqtAccumulation[perspective][k] += psqtWeights[index * PSQTBuckets + k];
           }
         }
-  #endif
       }
       else
       {
-        // Refresh the accumulator
-        auto& accumulator = pos.state()->accumulator;
+        // Refresh the accumulator from the per-thread cache keyed by king
+        // square (a "finny table"): apply only the features that differ from
+        // the cached piece placement instead of rebuilding from the biases.
+        auto& accumulator = *pos.state()->accumulator;
         accumulator.computed[perspective] = true;
-        IndexList active;
-        FeatureSet::append_active_indices(pos, perspective, active);
+
+        AccumulatorRefreshEntry& entry =
+            pos.this_thread()->refreshTable.entries[perspective][pos.square<KING>(perspective)];
+
+        if (!entry.valid)
+        {
+            // Cold entry: initialize to the empty board, so that the diff
+            // below degenerates into a classic full refresh.
+            std::memcpy(entry.accumulation, biases, HalfDimensions * sizeof(BiasType));
+            std::memset(entry.psqtAccumulation, 0, sizeof(entry.psqtAccumulation));
+            std::memset(entry.byColorBB, 0, sizeof(entry.byColorBB));
+            std::memset(entry.byTypeBB, 0, sizeof(entry.byTypeBB));
+            entry.valid = true;
+        }
+
+        IndexList removed, added;
+        FeatureSet::append_refresh_indices(pos, perspective,
+                                           entry.byColorBB, entry.byTypeBB,
+                                           removed, added);
+
+        for (Color c : { WHITE, BLACK })
+            entry.byColorBB[c] = pos.pieces(c);
+
+        for (PieceType pt = PAWN; pt <= KING; ++pt)
+            entry.byTypeBB[pt] = pos.pieces(pt);
 
   #ifdef VECTOR
+        if (!Dispatch::Wide)
+        {
+        // As in the incremental path above, gather the weight rows first so
+        // each tile is updated in one fused chain. The refresh diff can touch
+        // up to 32 rows, making the per-tile offset arithmetic it saves the
+        // largest of all update shapes.
+        int numSub = 0, numAdd = 0;
+        const WeightType*     subColumns[FeatureSet::MaxActiveDimensions];
+        const WeightType*     addColumns[FeatureSet::MaxActiveDimensions];
+        const PSQTWeightType* subColumnsPsqt[FeatureSet::MaxActiveDimensions];
+        const PSQTWeightType* addColumnsPsqt[FeatureSet::MaxActiveDimensions];
+
+        for (const auto index : removed)
+        {
+          subColumns[numSub] = &weights[HalfDimensions * index];
+          subColumnsPsqt[numSub++] = &psqtWeights[PSQTBuckets * index];
+        }
+
+        for (const auto index : added)
+        {
+          addColumns[numAdd] = &weights[HalfDimensions * index];
+          addColumnsPsqt[numAdd++] = &psqtWeights[PSQTBuckets * index];
+        }
+
         for (IndexType j = 0; j < HalfDimensions / TileHeight; ++j)
         {
-          auto biasesTile = reinterpret_cast<const vec_t*>(
-              &biases[j * TileHeight]);
+          auto entryTile = reinterpret_cast<vec_t*>(
+              &entry.accumulation[j * TileHeight]);
           for (IndexType k = 0; k < NumRegs; ++k)
-            acc[k] = biasesTile[k];
+            acc[k] = vec_load(&entryTile[k]);
+
+          for (int n = 0; n < numSub; ++n)
+          {
+            auto column = reinterpret_cast<const vec_t*>(subColumns[n] + j * TileHeight);
+
+            for (unsigned k = 0; k < NumRegs; ++k)
+              acc[k] = vec_sub_16(acc[k], column[k]);
+          }
 
-          for (const auto index : active)
+          for (int n = 0; n < numAdd; ++n)
           {
-            const IndexType offset = HalfDimensions * index + j * TileHeight;
-            auto column = reinterpret_cast<const vec_t*>(&weights[offset]);
+            auto column = reinterpret_cast<const vec_t*>(addColumns[n] + j * TileHeight);
 
             for (unsigned k = 0; k < NumRegs; ++k)
               acc[k] = vec_add_16(acc[k], column[k]);
@@ -557,18 +659,30 @@ namespace Stockfish::Eval::NNUE {
           auto accTile = reinterpret_cast<vec_t*>(
               &accumulator.accumulation[perspective][j * TileHeight]);
           for (unsigned k = 0; k < NumRegs; k++)
+          {
+            vec_store(&entryTile[k], acc[k]);
             vec_store(&accTile[k], acc[k]);
+          }
         }
 
         for (IndexType j = 0; j < PSQTBuckets / PsqtTileHeight; ++j)
         {
+          auto entryTilePsqt = reinterpret_cast<psqt_vec_t*>(
+              &entry.psqtAccumulation[j * PsqtTileHeight]);
           for (std::size_t k = 0; k < NumPsqtRegs; ++k)
-            psqt[k] = vec_zero_psqt();
+            psqt[k] = vec_load_psqt(&entryTilePsqt[k]);
 
-          for (const auto index : active)
+          for (int n = 0; n < numSub; ++n)
           {
-            const IndexType offset = PSQTBuckets * index + j * PsqtTileHeight;
-            auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(&psqtWeights[offset]);
+            auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(subColumnsPsqt[n] + j * PsqtTileHeight);
+
+            for (std::size_t k = 0; k < NumPsqtRegs; ++k)
+              psqt[k] = vec_sub_psqt_32(psqt[k], columnPsqt[k]);
+          }
+
+          for (int n = 0; n < numAdd; ++n)
+          {
+            auto columnPsqt = reinterpret_cast<const psqt_vec_t*>(addColumnsPsqt[n] + j * PsqtTileHeight);
 
             for (std::size_t k = 0; k < NumPsqtRegs; ++k)
               psqt[k] = vec_add_psqt_32(psqt[k], columnPsqt[k]);
@@ -577,27 +691,39 @@ namespace Stockfish::Eval::NNUE {
           auto accTilePsqt = reinterpret_cast<psqt_vec_t*>(
             &accumulator.psqtAccumulation[perspective][j * PsqtTileHeight]);
           for (std::size_t k = 0; k < NumPsqtRegs; ++k)
+          {
+            vec_store_psqt(&entryTilePsqt[k], psqt[k]);
             vec_store_psqt(&accTilePsqt[k], psqt[k]);
+          }
         }
+        }
+        else
+  #endif
+        {
+        for (const auto index : removed)
+        {
+          Dispatch::sub_column(entry.accumulation,
+                               &weights[HalfDimensions * index], HalfDimensions);
 
-  #else
-        std::memcpy(accumulator.accumulation[perspective], biases,
-            HalfDimensions * sizeof(BiasType));
-
-        for (std::size_t k = 0; k < PSQTBuckets; ++k)
-          accumulator.psqtAccumulation[perspective][k] = 0;
+          for (std::size_t k = 0; k < PSQTBuckets; ++k)
+            entry.psqtAccumulation[k] -= psqtWeights[index * PSQTBuckets + k];
+        }
 
-        for (const auto index : active)
+        for (const auto index : added)
         {
-          const IndexType offset = HalfDimensions * index;
-
-          for (IndexType j = 0; j < HalfDimensions; ++j)
-            accumulator.accumulation[perspective][j] += weights[offset + j];
+          Dispatch::add_column(entry.accumulation,
+                               &weights[HalfDimensions * index], HalfDimensions);
 
           for (std::size_t k = 0; k < PSQTBuckets; ++k)
-            accumulator.psqtAccumulation[perspective][k] += psqtWeights[index * PSQTBuckets + k];
+            entry.psqtAccumulation[k] += psqtWeights[index * PSQTBuckets + k];
+        }
+
+        std::memcpy(accumulator.accumulation[perspective], entry.accumulation,
+            HalfDimensions * sizeof(BiasType));
+
+        for (std::size_t k = 0; k < PSQTBuckets; ++k)
+          accumulator.psqtAccumulation[perspective][k] = entry.psqtAccumulation[k];
         }
-  #endif
       }
 
   #if defined(USE_MMX)
@@ -0,0 +1,92 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include "nnue_simd_dispatch.h"
+
+// Function multiversioning needs GCC, x86-64 and ELF ifunc support. On other
+// configurations the kernels compile as plain functions and init() leaves
+// dispatch disabled, so the compile-time SIMD paths are used as before.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__)
+#define DISPATCH_ENABLED
+#define DISPATCH_CLONES __attribute__((target_clones("arch=x86-64-v4", "avx2", "default")))
+#else
+#define DISPATCH_CLONES
+#endif
+
+namespace Stockfish::Eval::NNUE::Dispatch {
+
+bool Wide = false;
+
+void init() {
+
+// A binary already compiled for AVX2 or wider keeps its hand-tuned
+// intrinsics; dispatch only upgrades narrower builds on wider hosts.
+#if defined(DISPATCH_ENABLED) && !defined(USE_AVX2)
+  Wide = __builtin_cpu_supports("avx2");
+#endif
+}
+
+DISPATCH_CLONES
+void add_column(std::int16_t* acc, const std::int16_t* column, unsigned n) {
+
+  for (unsigned j = 0; j < n; ++j)
+      acc[j] += column[j];
+}
+
+DISPATCH_CLONES
+void sub_column(std::int16_t* acc, const std::int16_t* column, unsigned n) {
+
+  for (unsigned j = 0; j < n; ++j)
+      acc[j] -= column[j];
+}
+
+DISPATCH_CLONES
+void clip_to_u8(const std::int16_t* in, std::uint8_t* out, unsigned n) {
+
+  for (unsigned j = 0; j < n; ++j)
+      out[j] = std::uint8_t(std::max(0, std::min(127, int(in[j]))));
+}
+
+DISPATCH_CLONES
+void scale_clip_to_u8(const std::int32_t* in, std::uint8_t* out,
+                      unsigned n, int shift) {
+
+  for (unsigned j = 0; j < n; ++j)
+      out[j] = std::uint8_t(std::max(0, std::min(127, in[j] >> shift)));
+}
+
+DISPATCH_CLONES
+void affine(const std::int8_t* weights, const std::int32_t* biases,
+            const std::uint8_t* in, std::int32_t* out,
+            unsigned inDims, unsigned paddedInDims, unsigned outDims) {
+
+  for (unsigned i = 0; i < outDims; ++i)
+  {
+      std::int32_t sum = biases[i];
+      const std::int8_t* row = &weights[i * paddedInDims];
+
+      for (unsigned j = 0; j < inDims; ++j)
+          sum += row[j] * in[j];
+
+      out[i] = sum;
+  }
+}
+
+}  // namespace Stockfish::Eval::NNUE::Dispatch
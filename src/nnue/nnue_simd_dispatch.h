@@ -0,0 +1,62 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Runtime-dispatched SIMD kernels for the NNUE hot loops
+
+#ifndef NNUE_SIMD_DISPATCH_H_INCLUDED
+#define NNUE_SIMD_DISPATCH_H_INCLUDED
+
+#include <cstdint>
+
+namespace Stockfish::Eval::NNUE::Dispatch {
+
+  // The Makefile bakes a single SIMD level into the NNUE code at compile
+  // time, so one binary deployed across a mixed fleet has to target its
+  // weakest machine. The kernels below are additionally compiled as AVX2
+  // and AVX-512 clones (GCC target_clones), and the loader binds the widest
+  // variant the CPU supports once at startup. init() enables routing the
+  // feature transformer and the affine/ReLU layers through them whenever
+  // the host offers a wider instruction set than the compile-time target;
+  // a build that already matches its host is unaffected.
+
+  // True when the host CPU is wider than the compiled SIMD level
+  extern bool Wide;
+
+  void init();
+
+  // Accumulator column add/subtract over n int16 lanes
+  void add_column(std::int16_t* acc, const std::int16_t* column, unsigned n);
+  void sub_column(std::int16_t* acc, const std::int16_t* column, unsigned n);
+
+  // Clamp n int16 accumulator values to [0, 127] bytes
+  void clip_to_u8(const std::int16_t* in, std::uint8_t* out, unsigned n);
+
+  // Shift n int32 layer outputs right and clamp to [0, 127] bytes
+  void scale_clip_to_u8(const std::int32_t* in, std::uint8_t* out,
+                        unsigned n, int shift);
+
+  // Dense int8 x uint8 affine layer with row stride paddedInDims. Only valid
+  // for the natural weight ordering, i.e. not for USE_SSSE3 builds, which
+  // permute the weights at load time.
+  void affine(const std::int8_t* weights, const std::int32_t* biases,
+              const std::uint8_t* in, std::int32_t* out,
+              unsigned inDims, unsigned paddedInDims, unsigned outDims);
+
+}  // namespace Stockfish::Eval::NNUE::Dispatch
+
+#endif // #ifndef NNUE_SIMD_DISPATCH_H_INCLUDED
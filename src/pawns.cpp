@@ -201,6 +201,14 @@ namespace {
 
 namespace Pawns {
 
+// Optional process-wide pawn hash, so that hot pawn structures are computed
+// once per structure instead of once per thread. Empty (off) by default.
+static SharedHashTable<Entry> sharedTable;
+
+void set_shared_size(size_t mbSize) {
+  sharedTable.resize(mbSize * 1024 * 1024 / sizeof(Entry));
+}
+
 
 /// Pawns::probe() looks up the current position's pawns configuration in
 /// the pawns hash table. It returns a pointer to the Entry if the position
@@ -210,7 +218,8 @@ namespace Pawns {
 Entry* probe(const Position& pos) {
 
   Key key = pos.pawn_key();
-  Entry* e = pos.this_thread()->pawnsTable[key];
+  Entry* e = sharedTable.enabled() ? sharedTable[key]
+                                   : pos.this_thread()->pawnsTable[key];
 
   if (e->key == key)
       return e;
@@ -65,6 +65,10 @@ typedef HashTable<Entry, 131072> Table;
 
 Entry* probe(const Position& pos);
 
+// Sets the size (in MB) of the optional process-wide pawn hash shared by all
+// threads; a size of zero falls back to the per-thread tables.
+void set_shared_size(size_t mbSize);
+
 } // namespace Stockfish::Pawns
 
 #endif // #ifndef PAWNS_H_INCLUDED
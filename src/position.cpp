@@ -79,7 +79,6 @@ std::ostream& operator<<(std::ostream& os, const Position& pos) {
       && !pos.can_castle(ANY_CASTLING))
   {
       StateInfo st;
-      ASSERT_ALIGNED(&st, Eval::NNUE::CacheLineSize);
 
       Position p;
       p.set(pos.fen(), pos.is_chess960(), &st, pos.this_thread());
@@ -197,8 +196,16 @@ Position& Position::set(const string& fenStr, bool isChess960, StateInfo* si, Th
   Square sq = SQ_A8;
   std::istringstream ss(fenStr);
 
+  // The pooled accumulator storage is reused across set() calls, so it must
+  // survive the wipe below.
+  Eval::NNUE::AccumulatorPool* pool = accPool;
+
   std::memset(this, 0, sizeof(Position));
   std::memset(si, 0, sizeof(StateInfo));
+
+  accPool = pool ? pool : new Eval::NNUE::AccumulatorPool;
+  accPool->reset();
+  si->accumulator = accPool->push();
   st = si;
 
   ss >> std::noskipws;
@@ -325,6 +332,8 @@ void Position::set_check_info(StateInfo* si) const {
   si->checkSquares[ROOK]   = attacks_bb<ROOK>(ksq, pieces());
   si->checkSquares[QUEEN]  = si->checkSquares[BISHOP] | si->checkSquares[ROOK];
   si->checkSquares[KING]   = 0;
+
+  si->checkInfoReady = true;
 }
 
 
@@ -550,6 +559,92 @@ bool Position::legal(Move m) const {
 }
 
 
+/// Position::has_legal_moves() tests for at least one legal move without
+/// materializing a move list, so stalemate and checkmate questions are
+/// answered from attack bitboards with early exits. Any pseudo-legal move of
+/// an unpinned piece other than the king is legal outright; pinned pieces are
+/// restricted to the pin line and king moves to unattacked squares. Check
+/// evasions and en passant captures are rare and full of discovered-check
+/// subtleties, so they stay with the tried-and-true per-move legality test.
+
+bool Position::has_legal_moves() const {
+
+  Color us = sideToMove;
+  Square ksq = square<KING>(us);
+  Bitboard target = ~pieces(us);
+  Bitboard b = attacks_bb<KING>(ksq) & target;
+
+  while (b)
+      if (!(attackers_to(pop_lsb(b), pieces() ^ ksq) & pieces(~us)))
+          return true;
+
+  // When in check, the remaining candidates block or capture the checker
+  // (king moves were covered above, castling is never an evasion)
+  if (checkers())
+  {
+      for (const auto& m : MoveList<EVASIONS>(*this))
+          if (type_of(piece_on(from_sq(m))) != KING && legal(m))
+              return true;
+      return false;
+  }
+
+  Bitboard pinned = blockers_for_king(us) & pieces(us);
+
+  // A pinned knight can never move; unpinned ones move freely
+  b = pieces(us, KNIGHT) & ~pinned;
+  while (b)
+      if (attacks_bb<KNIGHT>(pop_lsb(b)) & target)
+          return true;
+
+  // Sliders keep their moves along the pin line even when pinned
+  b = pieces(us, QUEEN) | pieces(us, BISHOP, ROOK);
+  while (b)
+  {
+      Square s = pop_lsb(b);
+      Bitboard moves = attacks_bb(type_of(piece_on(s)), s, pieces()) & target;
+
+      if (pinned & s ? moves & line_bb(ksq, s) : moves)
+          return true;
+  }
+
+  // An unpinned pawn that can push a single step or capture has a legal
+  // move; this also proves double pushes and promotions when they exist.
+  Bitboard pawns = pieces(us, PAWN) & ~pinned;
+
+  if (   ((us == WHITE ? shift<NORTH>(pawns) : shift<SOUTH>(pawns)) & ~pieces())
+      || ((us == WHITE ? pawn_attacks_bb<WHITE>(pawns) : pawn_attacks_bb<BLACK>(pawns)) & pieces(~us)))
+      return true;
+
+  b = pieces(us, PAWN) & pinned;
+  while (b)
+  {
+      Square s = pop_lsb(b);
+
+      if (   (empty(s + pawn_push(us)) && aligned(s, s + pawn_push(us), ksq))
+          || (pawn_attacks_bb(us, s) & pieces(~us) & line_bb(ksq, s)))
+          return true;
+  }
+
+  if (ep_square() != SQ_NONE)
+  {
+      b = pawn_attacks_bb(~us, ep_square()) & pieces(us, PAWN);
+      while (b)
+          if (legal(make<EN_PASSANT>(pop_lsb(b), ep_square())))
+              return true;
+  }
+
+  // Chess960 castling can be legal although neither the king nor the rook
+  // has an ordinary legal move (king and rook swapping places)
+  if (chess960)
+      for (CastlingRights cr : { us & KING_SIDE, us & QUEEN_SIDE })
+          if (can_castle(cr) && !castling_impeded(cr)
+              && legal(make<CASTLING>(ksq, castling_rook_square(cr))))
+              return true;
+
+  return false;
+}
+
+
 /// Position::pseudo_legal() takes a random move and tests whether the move is
 /// pseudo legal. It is used to validate moves from TT that can be corrupted
 /// due to SMP concurrent access or hash position key aliasing.
@@ -701,9 +796,8 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
   ++st->rule50;
   ++st->pliesFromNull;
 
-  // Used by NNUE
-  st->accumulator.computed[WHITE] = false;
-  st->accumulator.computed[BLACK] = false;
+  // Used by NNUE. push() hands out a block with cleared computed flags.
+  st->accumulator = accPool->push();
   auto& dp = st->dirtyPiece;
   dp.dirty_num = 1;
 
@@ -867,8 +961,9 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
 
   sideToMove = ~sideToMove;
 
-  // Update king attacks used for fast check detection
-  set_check_info(st);
+  // King attacks used for fast check detection are computed lazily on first
+  // access, as most nodes cut off before consulting them
+  st->checkInfoReady = false;
 
   // Calculate the repetition info. It is the ply distance from the previous
   // occurrence of the same position, negative in the 3-fold case, or zero
@@ -949,7 +1044,9 @@ void Position::undo_move(Move m) {
       }
   }
 
-  // Finally point our state pointer back to the previous state
+  // Finally point our state pointer back to the previous state and hand the
+  // undone state's accumulator block back to the pool.
+  accPool->pop();
   st = st->previous;
   --gamePly;
 
@@ -1003,8 +1100,7 @@ void Position::do_null_move(StateInfo& newSt) {
 
   st->dirtyPiece.dirty_num = 0;
   st->dirtyPiece.piece[0] = NO_PIECE; // Avoid checks in UpdateAccumulator()
-  st->accumulator.computed[WHITE] = false;
-  st->accumulator.computed[BLACK] = false;
+  st->accumulator = accPool->push();
 
   if (st->epSquare != SQ_NONE)
   {
@@ -1020,7 +1116,7 @@ void Position::do_null_move(StateInfo& newSt) {
 
   sideToMove = ~sideToMove;
 
-  set_check_info(st);
+  st->checkInfoReady = false;
 
   st->repetition = 0;
 
@@ -1034,6 +1130,7 @@ void Position::undo_null_move() {
 
   assert(!checkers());
 
+  accPool->pop();
   st = st->previous;
   sideToMove = ~sideToMove;
 }
@@ -1086,6 +1183,11 @@ bool Position::see_ge(Move m, Value threshold) const {
   Bitboard stmAttackers, bb;
   int res = 1;
 
+  // The piece bitboards never change during the swap sequence (only the
+  // occupancy does), so the x-ray candidate sets are loop invariants.
+  Bitboard diagXrays = pieces(BISHOP, QUEEN);
+  Bitboard lineXrays = pieces(ROOK, QUEEN);
+
   while (true)
   {
       stm = ~stm;
@@ -1105,60 +1207,57 @@ bool Position::see_ge(Move m, Value threshold) const {
 
       res ^= 1;
 
-      // Locate and remove the next least valuable attacker, and add to
-      // the bitboard 'attackers' any X-ray attackers behind it.
-      if ((bb = stmAttackers & pieces(PAWN)))
-      {
-          if ((swap = PawnValueMg - swap) < res)
+      // Locate the next least valuable attacker
+      PieceType pt;
+      for (pt = PAWN; pt < KING; ++pt)
+          if ((bb = stmAttackers & pieces(pt)))
               break;
 
-          occupied ^= least_significant_square_bb(bb);
-          attackers |= attacks_bb<BISHOP>(to, occupied) & pieces(BISHOP, QUEEN);
-      }
+      // If we "capture" with the king but opponent still has attackers,
+      // reverse the result.
+      if (pt == KING)
+          return (attackers & ~pieces(stm)) ? res ^ 1 : res;
 
-      else if ((bb = stmAttackers & pieces(KNIGHT)))
-      {
-          if ((swap = KnightValueMg - swap) < res)
-              break;
+      if ((swap = PieceValue[MG][pt] - swap) < res)
+          break;
 
-          occupied ^= least_significant_square_bb(bb);
-      }
+      // Remove the attacker, and add to the bitboard 'attackers' any X-ray
+      // attackers uncovered behind it.
+      occupied ^= least_significant_square_bb(bb);
 
-      else if ((bb = stmAttackers & pieces(BISHOP)))
-      {
-          if ((swap = BishopValueMg - swap) < res)
-              break;
+      if (pt == PAWN || pt == BISHOP || pt == QUEEN)
+          attackers |= attacks_bb<BISHOP>(to, occupied) & diagXrays;
 
-          occupied ^= least_significant_square_bb(bb);
-          attackers |= attacks_bb<BISHOP>(to, occupied) & pieces(BISHOP, QUEEN);
-      }
+      if (pt == ROOK || pt == QUEEN)
+          attackers |= attacks_bb<ROOK>(to, occupied) & lineXrays;
+  }
 
-      else if ((bb = stmAttackers & pieces(ROOK)))
-      {
-          if ((swap = RookValueMg - swap) < res)
-              break;
+  return bool(res);
+}
 
-          occupied ^= least_significant_square_bb(bb);
-          attackers |= attacks_bb<ROOK>(to, occupied) & pieces(ROOK, QUEEN);
-      }
 
-      else if ((bb = stmAttackers & pieces(QUEEN)))
-      {
-          if ((swap = QueenValueMg - swap) < res)
-              break;
+/// Position::see_ge() overload memoizing its outcome in a per-node cache.
+/// A hit whose recorded bounds decide the query skips the swap sequence
+/// entirely; otherwise the computed result tightens the bounds for the
+/// next probe of the same move.
 
-          occupied ^= least_significant_square_bb(bb);
-          attackers |=  (attacks_bb<BISHOP>(to, occupied) & pieces(BISHOP, QUEEN))
-                      | (attacks_bb<ROOK  >(to, occupied) & pieces(ROOK  , QUEEN));
-      }
+bool Position::see_ge(Move m, Value threshold, SEECache& cache) const {
 
-      else // KING
-           // If we "capture" with the king but opponent still has attackers,
-           // reverse the result.
-          return (attackers & ~pieces(stm)) ? res ^ 1 : res;
-  }
+  SEECache::Entry& e = cache.entries[m & (SEECache::Size - 1)];
 
-  return bool(res);
+  if (e.move != m)
+      e = { m, -VALUE_INFINITE, VALUE_INFINITE };
+
+  else if (threshold <= e.pass)
+      return true;
+
+  else if (threshold >= e.fail)
+      return false;
+
+  bool res = see_ge(m, threshold);
+  (res ? e.pass : e.fail) = threshold;
+
+  return res;
 }
 
 
@@ -1167,7 +1266,7 @@ bool Position::see_ge(Move m, Value threshold) const {
 
 bool Position::is_draw(int ply) const {
 
-  if (st->rule50 > 99 && (!checkers() || MoveList<LEGAL>(*this).size()))
+  if (st->rule50 > 99 && (!checkers() || has_legal_moves()))
       return true;
 
   // Return a draw score if a position repeats once earlier but strictly
@@ -1317,8 +1416,13 @@ bool Position::pos_is_ok() const {
           if (p1 != p2 && (pieces(p1) & pieces(p2)))
               assert(0 && "pos_is_ok: Bitboards");
 
+  // Materialize any pending lazy check info so that the freshly computed
+  // copy below compares equal. The cache-line assert is gone along with the
+  // inline accumulator: StateInfo is not over-aligned anymore.
+  if (!st->checkInfoReady)
+      set_check_info(st);
+
   StateInfo si = *st;
-  ASSERT_ALIGNED(&si, Eval::NNUE::CacheLineSize);
 
   set_state(&si);
   if (std::memcmp(&si, st, sizeof(StateInfo)))
@@ -25,6 +25,7 @@
 #include <string>
 
 #include "bitboard.h"
+#include "misc.h"
 #include "evaluate.h"
 #include "psqt.h"
 #include "types.h"
@@ -58,8 +59,16 @@ struct StateInfo {
   Piece      capturedPiece;
   int        repetition;
 
-  // Used by NNUE
-  Eval::NNUE::Accumulator accumulator;
+  // Check info (blockersForKing, pinners and checkSquares) is materialized
+  // lazily: do_move() only clears this flag and the accessors run
+  // set_check_info() on first use, since most nodes fail high on the TT
+  // move before any of it is consulted.
+  bool       checkInfoReady;
+
+  // Used by NNUE. The accumulator lives in pooled storage owned by the
+  // Position (see AccumulatorPool), attached in set()/do_move() and released
+  // in undo_move(), so this struct stays small enough to copy cheaply.
+  Eval::NNUE::Accumulator* accumulator;
   DirtyPiece dirtyPiece;
 };
 
@@ -67,8 +76,33 @@ struct StateInfo {
 /// A list to keep track of the position states along the setup moves (from the
 /// start position to the position just before the search starts). Needed by
 /// 'draw by repetition' detection. Use a std::deque because pointers to
-/// elements are not invalidated upon list resizing.
-typedef std::unique_ptr<std::deque<StateInfo>> StateListPtr;
+/// elements are not invalidated upon list resizing. The deque draws its nodes
+/// from a per-thread free list, so rebuilding the list on every 'position'
+/// command stays off the system allocator.
+typedef std::deque<StateInfo, FreeListAllocator<StateInfo>> StateList;
+typedef std::unique_ptr<StateList> StateListPtr;
+
+
+/// SEECache memoizes see_ge() outcomes for the moves of a single node. The
+/// search and the move picker often probe the same move against different
+/// thresholds; because SEE is a fixed value per move, a passed threshold
+/// bounds it from below and a failed one from above, so later probes that
+/// fall outside the open interval are answered without rerunning the swap
+/// sequence. One instance lives in each search Stack entry and is cleared
+/// on node entry.
+struct SEECache {
+
+  struct Entry { Move move; Value pass, fail; };
+
+  static constexpr int Size = 16;
+
+  void clear() {
+    for (Entry& e : entries)
+        e.move = MOVE_NONE;
+  }
+
+  Entry entries[Size]; // Direct-mapped on the move's low bits
+};
 
 
 /// Position class stores information regarding the board representation as
@@ -82,6 +116,7 @@ public:
   static void init();
 
   Position() = default;
+ ~Position() { delete accPool; }
   Position(const Position&) = delete;
   Position& operator=(const Position&) = delete;
 
@@ -123,6 +158,7 @@ public:
 
   // Properties of moves
   bool legal(Move m) const;
+  bool has_legal_moves() const;
   bool pseudo_legal(const Move m) const;
   bool capture(Move m) const;
   bool capture_or_promotion(Move m) const;
@@ -144,6 +180,7 @@ public:
 
   // Static Exchange Evaluation
   bool see_ge(Move m, Value threshold = VALUE_ZERO) const;
+  bool see_ge(Move m, Value threshold, SEECache& cache) const;
 
   // Accessing hash keys
   Key key() const;
@@ -195,6 +232,9 @@ private:
   Bitboard castlingPath[CASTLING_RIGHT_NB];
   Thread* thisThread;
   StateInfo* st;
+  // Accumulator storage for the state chain. Allocated on first set() and
+  // kept across later ones, so the blocks survive the memset() in there.
+  Eval::NNUE::AccumulatorPool* accPool = nullptr;
   int gamePly;
   Color sideToMove;
   Score psq;
@@ -290,14 +330,20 @@ inline Bitboard Position::checkers() const {
 }
 
 inline Bitboard Position::blockers_for_king(Color c) const {
+  if (!st->checkInfoReady)
+      set_check_info(st);
   return st->blockersForKing[c];
 }
 
 inline Bitboard Position::pinners(Color c) const {
+  if (!st->checkInfoReady)
+      set_check_info(st);
   return st->pinners[c];
 }
 
 inline Bitboard Position::check_squares(PieceType pt) const {
+  if (!st->checkInfoReady)
+      set_check_info(st);
   return st->checkSquares[pt];
 }
 
@@ -17,18 +17,25 @@
 */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstring>   // For std::memset
 #include <iostream>
 #include <sstream>
 
+#include "book.h"
 #include "evaluate.h"
 #include "misc.h"
 #include "movegen.h"
 #include "movepick.h"
 #include "position.h"
 #include "search.h"
+#include "cluster.h"
+#include "searchstats.h"
+#include "searchtrace.h"
 #include "thread.h"
 #include "timeman.h"
 #include "tt.h"
@@ -44,7 +51,9 @@ namespace Search {
 
 namespace Tablebases {
 
-  int Cardinality;
+  // Atomic because the asynchronous root ranking can zero it out while the
+  // search threads are already probing; see rank_root_moves().
+  std::atomic<int> Cardinality;
   bool RootInTB;
   bool UseRule50;
   Depth ProbeDepth;
@@ -91,6 +100,69 @@ namespace {
     return VALUE_DRAW + Value(2 * (thisThread->nodes & 1) - 1);
   }
 
+  // AsyncRootRank holds the state of the asynchronous Syzygy root ranking.
+  // DTZ probes can stall for 100ms+ at move start when the tables sit on cold
+  // storage, so rank_root_moves() only launches the worker and the search
+  // starts right away; every thread adopts the published ranking between
+  // iterations once 'ready' is set. The worker probes a private copy of the
+  // root position, so it never touches the searching threads' state.
+  struct AsyncRootRank {
+
+    ~AsyncRootRank() { join(); }
+    void join() { if (worker.joinable()) worker.join(); }
+
+    std::thread worker;
+    std::atomic_bool ready = false;
+    Search::RootMoves ranked;      // Root moves with tbRank/tbScore filled in
+    bool rootInTB = false;
+    bool zeroCardinality = false;  // Stop in-search WDL probes once adopted
+  } asyncRootRank;
+
+  // Breadcrumbs are used to mark nodes as being searched by a given thread,
+  // an ABDADA-style coordination hint that keeps Lazy SMP threads from
+  // duplicating work in the same subtrees near the root.
+  struct Breadcrumb {
+    std::atomic<Thread*> thread;
+    std::atomic<uint64_t> key;
+  };
+  std::array<Breadcrumb, 1024> breadcrumbs;
+
+  // ThreadHolding structure keeps track of which thread left breadcrumbs at the given
+  // node for potential reductions. A free node will be marked upon entering the moves
+  // loop by the constructor, and unmarked upon leaving that loop by the destructor.
+  struct ThreadHolding {
+    explicit ThreadHolding(Thread* thisThread, Key posKey, int ply) {
+      location = ply < 8 ? &breadcrumbs[posKey & (breadcrumbs.size() - 1)] : nullptr;
+      otherThread = false;
+      owning = false;
+      if (location)
+      {
+          // See if another already marked this location, if not, mark it ourselves
+          Thread* tmp = (*location).thread.load(std::memory_order_relaxed);
+          if (tmp == nullptr)
+          {
+              (*location).thread.store(thisThread, std::memory_order_relaxed);
+              (*location).key.store(posKey, std::memory_order_relaxed);
+              owning = true;
+          }
+          else if (   tmp != thisThread
+                   && (*location).key.load(std::memory_order_relaxed) == posKey)
+              otherThread = true;
+      }
+    }
+
+    ~ThreadHolding() {
+      if (owning) // Free the marked location
+          (*location).thread.store(nullptr, std::memory_order_relaxed);
+    }
+
+    bool marked() { return otherThread; }
+
+    private:
+    Breadcrumb* location;
+    bool otherThread, owning;
+  };
+
   // Skill structure is used to implement strength limit
   struct Skill {
     explicit Skill(int l) : level(l) {}
@@ -122,7 +194,6 @@ namespace {
   uint64_t perft(Position& pos, Depth depth) {
 
     StateInfo st;
-    ASSERT_ALIGNED(&st, Eval::NNUE::CacheLineSize);
 
     uint64_t cnt, nodes = 0;
     const bool leaf = (depth == 2);
@@ -144,6 +215,80 @@ namespace {
     return nodes;
   }
 
+
+  // perft_parallel() splits perft over a team of worker threads. The first two
+  // plies are expanded into a queue of subtree tasks, from which idle workers
+  // keep stealing, so an uneven move tree cannot leave threads without work.
+  // Per-root-move counters are aggregated atomically and printed in generation
+  // order, matching the output of the serial version.
+  uint64_t perft_parallel(Position& pos, Depth depth, size_t threadCount) {
+
+    assert(depth >= 4);
+
+    const std::string fen = pos.fen();
+    const bool chess960 = pos.is_chess960();
+
+    struct Task {
+      size_t rootIdx;
+      Move rootMove, secondMove;
+    };
+
+    std::vector<Move> rootMoves;
+    for (const auto& m : MoveList<LEGAL>(pos))
+        rootMoves.push_back(m);
+
+    std::vector<Task> tasks;
+    {
+        StateInfo st;
+
+        for (size_t i = 0; i < rootMoves.size(); ++i)
+        {
+            pos.do_move(rootMoves[i], st);
+            for (const auto& m2 : MoveList<LEGAL>(pos))
+                tasks.push_back({ i, rootMoves[i], m2 });
+            pos.undo_move(rootMoves[i]);
+        }
+    }
+
+    std::vector<std::atomic<uint64_t>> rootCnt(rootMoves.size());
+    std::atomic<size_t> nextTask(0);
+
+    threadCount = std::max(size_t(1), std::min(threadCount, tasks.size()));
+
+    std::vector<std::thread> workers;
+    for (size_t idx = 0; idx < threadCount; ++idx)
+        workers.emplace_back([&]() {
+
+            Position p;
+            StateInfo rootSt, st1, st2;
+
+            p.set(fen, chess960, &rootSt, Threads.main());
+
+            size_t t;
+            while ((t = nextTask.fetch_add(1, std::memory_order_relaxed)) < tasks.size())
+            {
+                const Task& task = tasks[t];
+
+                p.do_move(task.rootMove, st1);
+                p.do_move(task.secondMove, st2);
+                rootCnt[task.rootIdx] += perft<false>(p, depth - 2);
+                p.undo_move(task.secondMove);
+                p.undo_move(task.rootMove);
+            }
+        });
+
+    for (auto& w : workers)
+        w.join();
+
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < rootMoves.size(); ++i)
+    {
+        sync_cout << UCI::move(rootMoves[i], chess960) << ": " << rootCnt[i].load() << sync_endl;
+        nodes += rootCnt[i].load();
+    }
+    return nodes;
+  }
+
 } // namespace
 
 
@@ -163,8 +308,10 @@ void Search::clear() {
   Threads.main()->wait_for_search_finished();
 
   Time.availableNodes = 0;
+  Time.reset_calibration();
   TT.clear();
   Threads.clear();
+  SearchStats::clear();
   Tablebases::init(Options["SyzygyPath"]); // Free mapped files
 }
 
@@ -176,7 +323,10 @@ void MainThread::search() {
 
   if (Limits.perft)
   {
-      nodes = perft<true>(rootPos, Limits.perft);
+      // Split shallow trees serially; deeper ones across the thread pool size
+      nodes = Limits.perft >= 4 && Options["Threads"] > 1
+            ? perft_parallel(rootPos, Limits.perft, size_t(Options["Threads"]))
+            : perft<true>(rootPos, Limits.perft);
       sync_cout << "\nNodes searched: " << nodes << "\n" << sync_endl;
       return;
   }
@@ -196,8 +346,22 @@ void MainThread::search() {
   }
   else
   {
-      Threads.start_searching(); // start non-main threads
-      Thread::search();          // main thread start searching
+      // Play instantly from the opening book when the position is still in
+      // it, saving the clock for later. Analysis is never short-circuited.
+      Move bookMove = MOVE_NONE;
+
+      if (!Limits.infinite && !Limits.mate)
+          bookMove = Book::probe(rootPos);
+
+      if (bookMove != MOVE_NONE && std::count(rootMoves.begin(), rootMoves.end(), bookMove))
+          for (Thread* th : Threads)
+              std::swap(th->rootMoves[0], *std::find(th->rootMoves.begin(),
+                                                     th->rootMoves.end(), bookMove));
+      else
+      {
+          Threads.start_searching(); // start non-main threads
+          Thread::search();          // main thread start searching
+      }
   }
 
   // When we reach the maximum depth, we can arrive here without a raise of
@@ -221,6 +385,14 @@ void MainThread::search() {
   if (Limits.npmsec)
       Time.availableNodes += Limits.inc[us] - Threads.nodes_searched();
 
+  // In partitioned MultiPV mode collect the slices searched by the other
+  // groups and send the combined, sorted set of lines.
+  if (Threads.pvGroups > 1 && Threads.pvOrderReady.load(std::memory_order_relaxed))
+  {
+      Threads.merge_pv_groups();
+      UCI::pv(rootPos, completedDepth, -VALUE_INFINITE, VALUE_INFINITE);
+  }
+
   Thread* bestThread = this;
 
   if (   int(Options["MultiPV"]) == 1
@@ -233,14 +405,21 @@ void MainThread::search() {
 
   // Send again PV info if we have a new best thread
   if (bestThread != this)
-      sync_cout << UCI::pv(bestThread->rootPos, bestThread->completedDepth, -VALUE_INFINITE, VALUE_INFINITE) << sync_endl;
+      UCI::pv(bestThread->rootPos, bestThread->completedDepth, -VALUE_INFINITE, VALUE_INFINITE);
+
+  // When a cluster coordinator drives this search, it prints the merged
+  // bestmove itself after collecting the workers' results
+  if (!Cluster::coordinating())
+  {
+      sync_cout << "bestmove " << UCI::move(bestThread->rootMoves[0].pv[0], rootPos.is_chess960());
 
-  sync_cout << "bestmove " << UCI::move(bestThread->rootMoves[0].pv[0], rootPos.is_chess960());
+      if (bestThread->rootMoves[0].pv.size() > 1 || bestThread->rootMoves[0].extract_ponder_from_tt(rootPos))
+          std::cout << " ponder " << UCI::move(bestThread->rootMoves[0].pv[1], rootPos.is_chess960());
 
-  if (bestThread->rootMoves[0].pv.size() > 1 || bestThread->rootMoves[0].extract_ponder_from_tt(rootPos))
-      std::cout << " ponder " << UCI::move(bestThread->rootMoves[0].pv[1], rootPos.is_chess960());
+      std::cout << sync_endl;
+  }
 
-  std::cout << sync_endl;
+  Time.on_bestmove(us); // For move-overhead auto-calibration
 }
 
 
@@ -250,12 +429,19 @@ void MainThread::search() {
 
 void Thread::search() {
 
+  // Histories marked dirty by ThreadPool::clear() are zeroed here, so each
+  // thread pays for its own tables on the core (and NUMA node) that uses them.
+  if (clearHistories)
+  {
+      clear();
+      clearHistories = false;
+  }
+
   // To allow access to (ss-7) up to (ss+2), the stack must be oversized.
   // The former is needed to allow update_continuation_histories(ss-1, ...),
   // which accesses its argument at ss-6, also near the root.
   // The latter is needed for statScore and killer initialization.
   Stack stack[MAX_PLY+10], *ss = stack+7;
-  Move  pv[MAX_PLY+1];
   Value bestValue, alpha, beta, delta;
   Move  lastBestMove = MOVE_NONE;
   Depth lastBestMoveDepth = 0;
@@ -271,7 +457,7 @@ void Thread::search() {
   for (int i = 0; i <= MAX_PLY + 2; ++i)
       (ss+i)->ply = i;
 
-  ss->pv = pv;
+  ss->pv = pvArena[0];
 
   bestValue = delta = alpha = -VALUE_INFINITE;
   beta = VALUE_INFINITE;
@@ -310,17 +496,73 @@ void Thread::search() {
       multiPV = std::max(multiPV, (size_t)4);
 
   multiPV = std::min(multiPV, rootMoves.size());
+
+  // In partitioned MultiPV mode this thread will, once the warmup iterations
+  // have established a move ranking, only search a slice of the lines.
+  size_t pvBegin = 0, pvEnd = multiPV;
+  bool pvSliced = false;
+
   ttHitAverage = TtHitAverageWindow * TtHitAverageResolution / 2;
 
   trend = SCORE_ZERO;
 
   int searchAgainCounter = 0;
+  bool tbRanked = false;
 
   // Iterative deepening loop until requested to stop or the target depth is reached
   while (   ++rootDepth < MAX_PLY
          && !Threads.stop
          && !(Limits.depth && mainThread && rootDepth > Limits.depth))
   {
+      // Adopt the asynchronous Syzygy root ranking once the background worker
+      // has published it; see Tablebases::rank_root_moves(). The stable sort
+      // keeps the move ordering found so far within equal TB ranks. After the
+      // partitioned-MultiPV slicing below the threads must keep ranking the
+      // lines identically, so from then on only the ranks are adopted.
+      if (   !tbRanked
+          && asyncRootRank.ready.load(std::memory_order_acquire))
+      {
+          for (RootMove& rm : rootMoves)
+          {
+              auto it = std::find(asyncRootRank.ranked.begin(), asyncRootRank.ranked.end(), rm.pv[0]);
+              if (it != asyncRootRank.ranked.end())
+                  rm.tbRank = it->tbRank, rm.tbScore = it->tbScore;
+          }
+
+          if (!pvSliced)
+              std::stable_sort(rootMoves.begin(), rootMoves.end(),
+                        [](const RootMove &a, const RootMove &b) { return a.tbRank > b.tbRank; } );
+
+          if (mainThread)
+          {
+              TB::RootInTB = asyncRootRank.rootInTB;
+              if (asyncRootRank.zeroCardinality)
+                  TB::Cardinality = 0;
+          }
+
+          tbRanked = true;
+      }
+
+      // Adopt the published partitioned-MultiPV move order once, then search
+      // only the slice of lines owned by this thread's group. All threads
+      // rank the lines identically from here on, so the slices reference the
+      // same moves everywhere and can be merged by index afterwards.
+      if (   Threads.pvGroups > 1
+          && !pvSliced
+          && Threads.pvOrderReady.load(std::memory_order_acquire))
+      {
+          for (size_t i = 0; i < Threads.pvOrder.size(); ++i)
+          {
+              auto it = std::find(rootMoves.begin() + i, rootMoves.end(), Threads.pvOrder[i]);
+              if (it != rootMoves.end())
+                  std::rotate(rootMoves.begin() + i, it, it + 1);
+          }
+
+          pvBegin = std::min(pvOffset, multiPV);
+          pvEnd = pvCount ? std::min(pvOffset + pvCount, multiPV) : multiPV;
+          pvSliced = true;
+      }
+
       // Age out PV variability metric
       if (mainThread)
           totBestMoveChanges /= 2;
@@ -330,14 +572,14 @@ void Thread::search() {
       for (RootMove& rm : rootMoves)
           rm.previousScore = rm.score;
 
-      size_t pvFirst = 0;
-      pvLast = 0;
+      size_t pvFirst = pvBegin;
+      pvLast = pvBegin;
 
       if (!Threads.increaseDepth)
          searchAgainCounter++;
 
       // MultiPV loop. We perform a full root search for each PV line
-      for (pvIdx = 0; pvIdx < multiPV && !Threads.stop; ++pvIdx)
+      for (pvIdx = pvBegin; pvIdx < pvEnd && !Threads.stop; ++pvIdx)
       {
           if (pvIdx == pvLast)
           {
@@ -345,6 +587,10 @@ void Thread::search() {
               for (pvLast++; pvLast < rootMoves.size(); pvLast++)
                   if (rootMoves[pvLast].tbRank != rootMoves[pvFirst].tbRank)
                       break;
+
+              // Never reach into a slice owned by another group
+              if (pvSliced)
+                  pvLast = std::min(pvLast, pvEnd);
           }
 
           // Reset UCI info selDepth for each depth and each PV line
@@ -394,7 +640,7 @@ void Thread::search() {
                   && multiPV == 1
                   && (bestValue <= alpha || bestValue >= beta)
                   && Time.elapsed() > 3000)
-                  sync_cout << UCI::pv(rootPos, rootDepth, alpha, beta) << sync_endl;
+                  UCI::pv(rootPos, rootDepth, alpha, beta);
 
               // In case of failing low/high increase aspiration window and
               // re-search, otherwise exit the loop.
@@ -424,13 +670,27 @@ void Thread::search() {
           std::stable_sort(rootMoves.begin() + pvFirst, rootMoves.begin() + pvIdx + 1);
 
           if (    mainThread
-              && (Threads.stop || pvIdx + 1 == multiPV || Time.elapsed() > 3000))
-              sync_cout << UCI::pv(rootPos, rootDepth, alpha, beta) << sync_endl;
+              && (Threads.stop || pvIdx + 1 == pvEnd || Time.elapsed() > 3000))
+              UCI::pv(rootPos, rootDepth, alpha, beta);
       }
 
       if (!Threads.stop)
           completedDepth = rootDepth;
 
+      // Partitioned MultiPV: once the warmup iterations have produced a
+      // reasonable ranking of the lines, the main thread publishes its move
+      // order and all groups switch to searching just their own slice.
+      if (   Threads.pvGroups > 1
+          && mainThread
+          && completedDepth >= 5
+          && !Threads.pvOrderReady.load(std::memory_order_relaxed))
+      {
+          Threads.pvOrder.clear();
+          for (size_t i = 0; i < multiPV; ++i)
+              Threads.pvOrder.push_back(rootMoves[i].pv[0]);
+          Threads.pvOrderReady.store(true, std::memory_order_release);
+      }
+
       if (rootMoves[0].pv[0] != lastBestMove) {
          lastBestMove = rootMoves[0].pv[0];
          lastBestMoveDepth = rootDepth;
@@ -538,14 +798,14 @@ namespace {
     if (depth <= 0)
         return qsearch<PvNode ? PV : NonPV>(pos, ss, alpha, beta);
 
+    STATS_INC(mainNodes);
+
     assert(-VALUE_INFINITE <= alpha && alpha < beta && beta <= VALUE_INFINITE);
     assert(PvNode || (alpha == beta - 1));
     assert(0 < depth && depth < MAX_PLY);
     assert(!(PvNode && cutNode));
 
-    Move pv[MAX_PLY+1], capturesSearched[32], quietsSearched[64];
     StateInfo st;
-    ASSERT_ALIGNED(&st, Eval::NNUE::CacheLineSize);
 
     TTEntry* tte;
     Key posKey;
@@ -560,11 +820,19 @@ namespace {
 
     // Step 1. Initialize node
     Thread* thisThread = pos.this_thread();
+
+    // The PV line and the searched-move lists live in per-thread arenas
+    // indexed by ply, not in the native frame: see the comment in thread.h.
+    Move* const pv = thisThread->pvArena[ss->ply + 1];
+    Move* const capturesSearched = thisThread->capturesArena[ss->ply];
+    Move* const quietsSearched = thisThread->quietsArena[ss->ply];
+
     ss->inCheck        = pos.checkers();
     priorCapture       = pos.captured_piece();
     Color us           = pos.side_to_move();
     moveCount          = captureCount = quietCount = ss->moveCount = 0;
     bestValue          = -VALUE_INFINITE;
+    ss->seeCache.clear();
     maxValue           = VALUE_INFINITE;
 
     // Check for the available remaining time
@@ -618,6 +886,10 @@ namespace {
     excludedMove = ss->excludedMove;
     posKey = excludedMove == MOVE_NONE ? pos.key() : pos.key() ^ make_key(excludedMove);
     tte = TT.probe(posKey, ss->ttHit);
+
+    STATS_INC(ttProbes);
+    if (ss->ttHit)
+        STATS_INC(ttHits);
     ttValue = ss->ttHit ? value_from_tt(tte->value(), ss->ply, pos.rule50_count()) : VALUE_NONE;
     ttMove =  rootNode ? thisThread->rootMoves[thisThread->pvIdx].pv[0]
             : ss->ttHit    ? tte->move() : MOVE_NONE;
@@ -644,6 +916,8 @@ namespace {
         && (ttValue >= beta ? (tte->bound() & BOUND_LOWER)
                             : (tte->bound() & BOUND_UPPER)))
     {
+        STATS_INC(ttCutoffs);
+
         // If ttMove is quiet, update move sorting heuristics on TT hit
         if (ttMove)
         {
@@ -669,7 +943,11 @@ namespace {
         // Partial workaround for the graph history interaction problem
         // For high rule50 counts don't produce transposition table cutoffs.
         if (pos.rule50_count() < 90)
+        {
+            TRACE_NODE(ss->ply, ttMove, depth, VALUE_NONE, alpha, beta, ttValue,
+                       SearchTrace::TT_CUTOFF);
             return ttValue;
+        }
     }
 
     // Step 5. Tablebases probe
@@ -677,13 +955,23 @@ namespace {
     {
         int piecesCount = pos.count<ALL_PIECES>();
 
-        if (    piecesCount <= TB::Cardinality
-            && (piecesCount <  TB::Cardinality || depth >= TB::ProbeDepth)
+        // Throttle probing while this thread has been observing slow probes
+        // (cold page cache, network-hosted tables): require more depth, and
+        // at the extreme skip the largest piece sets until probes get cheap
+        // again.
+        int   cardinality = TB::Cardinality - thisThread->tbThrottle.reduce_cardinality();
+        Depth probeDepth  = TB::ProbeDepth  + thisThread->tbThrottle.extra_depth();
+
+        if (    piecesCount <= cardinality
+            && (piecesCount <  cardinality || depth >= probeDepth)
             &&  pos.rule50_count() == 0
             && !pos.can_castle(ANY_CASTLING))
         {
             TB::ProbeState err;
+            auto probeStart = std::chrono::steady_clock::now();
             TB::WDLScore wdl = Tablebases::probe_wdl(pos, &err);
+            thisThread->tbThrottle.update(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - probeStart).count());
 
             // Force check of time on the next occasion
             if (thisThread == Threads.main())
@@ -739,7 +1027,7 @@ namespace {
         // Never assume anything about values stored in TT
         ss->staticEval = eval = tte->eval();
         if (eval == VALUE_NONE)
-            ss->staticEval = eval = evaluate(pos);
+            ss->staticEval = eval = evaluate(pos, PvNode || depth > 6);
 
         // Randomize draw evaluation
         if (eval == VALUE_DRAW)
@@ -755,7 +1043,7 @@ namespace {
         // In case of null move search use previous static eval with a different sign
         // and addition of two tempos
         if ((ss-1)->currentMove != MOVE_NULL)
-            ss->staticEval = eval = evaluate(pos);
+            ss->staticEval = eval = evaluate(pos, PvNode || depth > 6);
         else
             ss->staticEval = eval = -(ss-1)->staticEval;
 
@@ -783,7 +1071,10 @@ namespace {
         &&  depth < 9
         &&  eval - futility_margin(depth, improving) >= beta
         &&  eval < VALUE_KNOWN_WIN) // Do not return unproven wins
+    {
+        STATS_INC(futilityPrunes);
         return eval;
+    }
 
     // Step 8. Null move search with verification search (~40 Elo)
     if (   !PvNode
@@ -804,6 +1095,8 @@ namespace {
         ss->currentMove = MOVE_NULL;
         ss->continuationHistory = &thisThread->continuationHistory[0][0][NO_PIECE][0];
 
+        STATS_INC(nullMoveTries);
+
         pos.do_null_move(st);
 
         Value nullValue = -search<NonPV>(pos, ss+1, -beta, -beta+1, depth-R, !cutNode);
@@ -812,12 +1105,18 @@ namespace {
 
         if (nullValue >= beta)
         {
+            STATS_INC(nullMoveCutoffs);
+
             // Do not return unproven mate or TB scores
             if (nullValue >= VALUE_TB_WIN_IN_MAX_PLY)
                 nullValue = beta;
 
             if (thisThread->nmpMinPly || (abs(beta) < VALUE_KNOWN_WIN && depth < 14))
+            {
+                TRACE_NODE(ss->ply, MOVE_NULL, depth, eval, alpha, beta, nullValue,
+                           SearchTrace::NULL_MOVE_CUTOFF);
                 return nullValue;
+            }
 
             assert(!thisThread->nmpMinPly); // Recursive verification is not allowed
 
@@ -938,12 +1237,16 @@ moves_loop: // When in check, search starts from here
                                       contHist,
                                       countermove,
                                       ss->killers,
-                                      ss->ply);
+                                      ss->ply,
+                                      &ss->seeCache);
 
     value = bestValue;
     singularQuietLMR = moveCountPruning = false;
     bool doubleExtension = false;
 
+    // Mark this node as being searched
+    ThreadHolding th(thisThread, posKey, ss->ply);
+
     // Indicate PvNodes that will probably fail low if the node was searched
     // at a depth equal or greater than the current depth, and the result of this search was a fail low.
     bool likelyFailLow =    PvNode
@@ -975,9 +1278,12 @@ moves_loop: // When in check, search starts from here
       ss->moveCount = ++moveCount;
 
       if (rootNode && thisThread == Threads.main() && Time.elapsed() > 3000)
-          sync_cout << "info depth " << depth
-                    << " currmove " << UCI::move(move, pos.is_chess960())
-                    << " currmovenumber " << moveCount + thisThread->pvIdx << sync_endl;
+      {
+          UCI::InfoWriter& w = UCI::writer();
+          (w << "info depth " << depth << " currmove ").move(move, pos.is_chess960());
+          w << " currmovenumber " << moveCount + thisThread->pvIdx << '\n';
+          w.flush();
+      }
       if (PvNode)
           (ss+1)->pv = nullptr;
 
@@ -1010,7 +1316,7 @@ moves_loop: // When in check, search starts from here
                   continue;
 
               // SEE based pruning
-              if (!pos.see_ge(move, Value(-218) * depth)) // (~25 Elo)
+              if (!pos.see_ge(move, Value(-218) * depth, ss->seeCache)) // (~25 Elo)
                   continue;
           }
           else
@@ -1032,7 +1338,7 @@ moves_loop: // When in check, search starts from here
                   continue;
 
               // Prune moves with negative SEE (~20 Elo)
-              if (!pos.see_ge(move, Value(-(30 - std::min(lmrDepth, 18)) * lmrDepth * lmrDepth)))
+              if (!pos.see_ge(move, Value(-(30 - std::min(lmrDepth, 18)) * lmrDepth * lmrDepth), ss->seeCache))
                   continue;
           }
       }
@@ -1137,6 +1443,11 @@ moves_loop: // When in check, search starts from here
           if (thisThread->ttHitAverage > 537 * TtHitAverageResolution * TtHitAverageWindow / 1024)
               r--;
 
+          // Reduce moves of a node another thread is already searching at the
+          // same time, deferring the duplicated work behind fresher subtrees
+          if (th.marked())
+              r++;
+
           // Decrease reduction if position is or has been on the PV
           // and node is not likely to fail low. (~3 Elo)
           if (   ss->ttPv
@@ -1182,6 +1493,8 @@ moves_loop: // When in check, search starts from here
           // to be searched deeper than the first move, unless ttMove was extended by 2.
           Depth d = std::clamp(newDepth - r, 1, newDepth + (r < -1 && moveCount <= 5 && !doubleExtension));
 
+          STATS_INC(lmrSearches);
+
           value = -search<NonPV>(pos, ss+1, -(alpha+1), -alpha, d, true);
 
           // If the son is reduced and fails high it will be re-searched at full depth
@@ -1197,6 +1510,9 @@ moves_loop: // When in check, search starts from here
       // Step 17. Full depth search when LMR is skipped or fails high
       if (doFullDepthSearch)
       {
+          if (didLMR)
+              STATS_INC(lmrReSearches);
+
           value = -search<NonPV>(pos, ss+1, -(alpha+1), -alpha, newDepth, !cutNode);
 
           // If the move passed LMR update its stats
@@ -1278,6 +1594,7 @@ moves_loop: // When in check, search starts from here
               else
               {
                   assert(value >= beta); // Fail high
+                  STATS_CUTOFF(moveCount);
                   break;
               }
           }
@@ -1345,6 +1662,9 @@ moves_loop: // When in check, search starts from here
 
     assert(bestValue > -VALUE_INFINITE && bestValue < VALUE_INFINITE);
 
+    TRACE_NODE(ss->ply, bestMove, depth, ss->staticEval, alpha, beta, bestValue,
+               bestValue >= beta ? SearchTrace::BETA_CUTOFF : SearchTrace::COMPLETED);
+
     return bestValue;
   }
 
@@ -1361,9 +1681,7 @@ moves_loop: // When in check, search starts from here
     assert(PvNode || (alpha == beta - 1));
     assert(depth <= 0);
 
-    Move pv[MAX_PLY+1];
     StateInfo st;
-    ASSERT_ALIGNED(&st, Eval::NNUE::CacheLineSize);
 
     TTEntry* tte;
     Key posKey;
@@ -1373,6 +1691,9 @@ moves_loop: // When in check, search starts from here
     bool pvHit, givesCheck, captureOrPromotion;
     int moveCount;
 
+    Thread* thisThread = pos.this_thread();
+    Move* const pv = thisThread->pvArena[ss->ply + 1];
+
     if (PvNode)
     {
         oldAlpha = alpha; // To flag BOUND_EXACT when eval above alpha and no available moves
@@ -1380,10 +1701,12 @@ moves_loop: // When in check, search starts from here
         ss->pv[0] = MOVE_NONE;
     }
 
-    Thread* thisThread = pos.this_thread();
     bestMove = MOVE_NONE;
     ss->inCheck = pos.checkers();
     moveCount = 0;
+    ss->seeCache.clear();
+
+    STATS_INC(qNodes);
 
     // Check for an immediate draw or maximum ply reached
     if (   pos.is_draw(ss->ply)
@@ -1424,7 +1747,7 @@ moves_loop: // When in check, search starts from here
         {
             // Never assume anything about values stored in TT
             if ((ss->staticEval = bestValue = tte->eval()) == VALUE_NONE)
-                ss->staticEval = bestValue = evaluate(pos);
+                ss->staticEval = bestValue = evaluate(pos, PvNode);
 
             // Can ttValue be used as a better position evaluation?
             if (    ttValue != VALUE_NONE
@@ -1435,7 +1758,7 @@ moves_loop: // When in check, search starts from here
             // In case of null move search use previous static eval with a different sign
             // and addition of two tempos
             ss->staticEval = bestValue =
-            (ss-1)->currentMove != MOVE_NULL ? evaluate(pos)
+            (ss-1)->currentMove != MOVE_NULL ? evaluate(pos, PvNode)
                                              : -(ss-1)->staticEval;
 
         // Stand pat. Return immediately if static value is at least beta
@@ -1459,6 +1782,16 @@ moves_loop: // When in check, search starts from here
                                           nullptr                   , (ss-4)->continuationHistory,
                                           nullptr                   , (ss-6)->continuationHistory };
 
+    // A capture whose victim is worth no more than this floor cannot raise
+    // the futility bound above alpha, so the MovePicker delta-prunes such
+    // victim classes at generation instead of materializing them for the
+    // pruning below. This also drops the rare low-victim capture that gives
+    // check, a trade the savings are worth.
+    Value victimFloor =    !ss->inCheck
+                        &&  bestValue > VALUE_TB_LOSS_IN_MAX_PLY
+                        &&  futilityBase > -VALUE_KNOWN_WIN
+                         ? alpha - futilityBase : -VALUE_INFINITE;
+
     // Initialize a MovePicker object for the current position, and prepare
     // to search the moves. Because the depth is <= 0 here, only captures,
     // queen promotions, and other checks (only if depth >= DEPTH_QS_CHECKS)
@@ -1466,7 +1799,8 @@ moves_loop: // When in check, search starts from here
     MovePicker mp(pos, ttMove, depth, &thisThread->mainHistory,
                                       &thisThread->captureHistory,
                                       contHist,
-                                      to_sq((ss-1)->currentMove));
+                                      to_sq((ss-1)->currentMove),
+                                      victimFloor);
 
     // Loop through the moves until no moves remain or a beta cutoff occurs
     while ((move = mp.next_move()) != MOVE_NONE)
@@ -1496,7 +1830,7 @@ moves_loop: // When in check, search starts from here
               continue;
           }
 
-          if (futilityBase <= alpha && !pos.see_ge(move, VALUE_ZERO + 1))
+          if (futilityBase <= alpha && !pos.see_ge(move, VALUE_ZERO + 1, ss->seeCache))
           {
               bestValue = std::max(bestValue, futilityBase);
               continue;
@@ -1505,7 +1839,7 @@ moves_loop: // When in check, search starts from here
 
       // Do not search moves with negative SEE values
       if (    bestValue > VALUE_TB_LOSS_IN_MAX_PLY
-          && !pos.see_ge(move))
+          && !pos.see_ge(move, VALUE_ZERO, ss->seeCache))
           continue;
 
       // Speculative prefetch as early as possible
@@ -1787,6 +2121,11 @@ void MainThread::check_time() {
       dbg_print();
   }
 
+  // Publish the live counters to the shared telemetry block, if enabled
+  if (Telemetry::due(elapsed))
+      Telemetry::publish(Threads.nodes_searched(), Threads.tb_hits(),
+                         TT.hashfull(), rootDepth, elapsed);
+
   // We should not stop pondering until told so by the GUI
   if (ponder)
       return;
@@ -1798,12 +2137,15 @@ void MainThread::check_time() {
 }
 
 
-/// UCI::pv() formats PV information according to the UCI protocol. UCI requires
-/// that all (if any) unsearched PV lines are sent using a previous search score.
+/// UCI::pv() formats PV information according to the UCI protocol and sends it
+/// out in one bulk write through the per-thread InfoWriter, so the hottest
+/// output path stays free of heap allocations however fast the iterations
+/// come. UCI requires that all (if any) unsearched PV lines are sent using a
+/// previous search score.
 
-string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
+void UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
 
-  std::stringstream ss;
+  InfoWriter& w = UCI::writer();
   TimePoint elapsed = Time.elapsed() + 1;
   const RootMoves& rootMoves = pos.this_thread()->rootMoves;
   size_t pvIdx = pos.this_thread()->pvIdx;
@@ -1827,36 +2169,36 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
       bool tb = TB::RootInTB && abs(v) < VALUE_MATE_IN_MAX_PLY;
       v = tb ? rootMoves[i].tbScore : v;
 
-      if (ss.rdbuf()->in_avail()) // Not at first line
-          ss << "\n";
-
-      ss << "info"
-         << " depth "    << d
-         << " seldepth " << rootMoves[i].selDepth
-         << " multipv "  << i + 1
-         << " score "    << UCI::value(v);
+      w << "info"
+        << " depth "    << d
+        << " seldepth " << rootMoves[i].selDepth
+        << " multipv "  << i + 1
+        << " score ";
+      w.value(v);
 
       if (Options["UCI_ShowWDL"])
-          ss << UCI::wdl(v, pos.game_ply());
+          w.wdl(v, pos.game_ply());
 
       if (!tb && i == pvIdx)
-          ss << (v >= beta ? " lowerbound" : v <= alpha ? " upperbound" : "");
+          w << (v >= beta ? " lowerbound" : v <= alpha ? " upperbound" : "");
 
-      ss << " nodes "    << nodesSearched
-         << " nps "      << nodesSearched * 1000 / elapsed;
+      w << " nodes "    << nodesSearched
+        << " nps "      << nodesSearched * 1000 / elapsed;
 
       if (elapsed > 1000) // Earlier makes little sense
-          ss << " hashfull " << TT.hashfull();
+          w << " hashfull " << TT.hashfull();
 
-      ss << " tbhits "   << tbHits
-         << " time "     << elapsed
-         << " pv";
+      w << " tbhits "   << tbHits
+        << " time "     << elapsed
+        << " pv";
 
       for (Move m : rootMoves[i].pv)
-          ss << " " << UCI::move(m, pos.is_chess960());
+          (w << ' ').move(m, pos.is_chess960());
+
+      w << '\n';
   }
 
-  return ss.str();
+  w.flush();
 }
 
 
@@ -1868,7 +2210,6 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
 bool RootMove::extract_ponder_from_tt(Position& pos) {
 
     StateInfo st;
-    ASSERT_ALIGNED(&st, Eval::NNUE::CacheLineSize);
 
     bool ttHit;
 
@@ -1893,11 +2234,14 @@ bool RootMove::extract_ponder_from_tt(Position& pos) {
 
 void Tablebases::rank_root_moves(Position& pos, Search::RootMoves& rootMoves) {
 
+    // The previous search can have finished before its ranking worker did
+    asyncRootRank.join();
+    asyncRootRank.ready.store(false, std::memory_order_relaxed);
+
     RootInTB = false;
     UseRule50 = bool(Options["Syzygy50MoveRule"]);
     ProbeDepth = int(Options["SyzygyProbeDepth"]);
     Cardinality = int(Options["SyzygyProbeLimit"]);
-    bool dtz_available = true;
 
     // Tables with fewer pieces than SyzygyProbeLimit are searched with
     // ProbeDepth == DEPTH_ZERO
@@ -1907,35 +2251,51 @@ void Tablebases::rank_root_moves(Position& pos, Search::RootMoves& rootMoves) {
         ProbeDepth = 0;
     }
 
-    if (Cardinality >= popcount(pos.pieces()) && !pos.can_castle(ANY_CASTLING))
-    {
+    if (Cardinality < popcount(pos.pieces()) || pos.can_castle(ANY_CASTLING))
+        return;
+
+    // Probing DTZ tables on cold storage can cost 100ms+ of dead time right
+    // at move start, so the actual probing runs on a background worker while
+    // the first shallow iterations already search in natural move order. The
+    // worker operates on a private copy of the position and of the root move
+    // list; its do_move() calls slightly inflate the main thread's node
+    // counter, which is harmless noise against a real search.
+    asyncRootRank.ranked = rootMoves;
+
+    asyncRootRank.worker = std::thread([fen = pos.fen(), chess960 = pos.is_chess960()]() {
+
+        StateInfo rootSt;
+        Position p;
+        p.set(fen, chess960, &rootSt, Threads.main());
+
         // Rank moves using DTZ tables
-        RootInTB = root_probe(pos, rootMoves);
+        bool dtzAvailable = true;
+        bool rootInTB = root_probe(p, asyncRootRank.ranked);
 
-        if (!RootInTB)
+        if (!rootInTB)
         {
             // DTZ tables are missing; try to rank moves using WDL tables
-            dtz_available = false;
-            RootInTB = root_probe_wdl(pos, rootMoves);
+            dtzAvailable = false;
+            rootInTB = root_probe_wdl(p, asyncRootRank.ranked);
         }
-    }
 
-    if (RootInTB)
-    {
-        // Sort moves according to TB rank
-        std::stable_sort(rootMoves.begin(), rootMoves.end(),
-                  [](const RootMove &a, const RootMove &b) { return a.tbRank > b.tbRank; } );
+        if (rootInTB)
+            // Sort moves according to TB rank
+            std::stable_sort(asyncRootRank.ranked.begin(), asyncRootRank.ranked.end(),
+                      [](const RootMove &a, const RootMove &b) { return a.tbRank > b.tbRank; } );
+        else
+            // Clean up if root_probe() and root_probe_wdl() have failed
+            for (auto& m : asyncRootRank.ranked)
+                m.tbRank = 0;
+
+        asyncRootRank.rootInTB = rootInTB;
 
         // Probe during search only if DTZ is not available and we are winning
-        if (dtz_available || rootMoves[0].tbScore <= VALUE_DRAW)
-            Cardinality = 0;
-    }
-    else
-    {
-        // Clean up if root_probe() and root_probe_wdl() have failed
-        for (auto& m : rootMoves)
-            m.tbRank = 0;
-    }
+        asyncRootRank.zeroCardinality =
+            rootInTB && (dtzAvailable || asyncRootRank.ranked[0].tbScore <= VALUE_DRAW);
+
+        asyncRootRank.ready.store(true, std::memory_order_release);
+    });
 }
 
 } // namespace Stockfish
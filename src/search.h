@@ -53,6 +53,31 @@ struct Stack {
   bool ttPv;
   bool ttHit;
   int doubleExtensions;
+  SEECache seeCache;
+};
+
+
+/// TBThrottle adapts in-search tablebase probing to the probe latency a
+/// thread actually observes. Tables served from a cold page cache or over
+/// the network can make a single WDL probe cost milliseconds, at which
+/// point probing every eligible low-depth node costs far more search than
+/// the cutoffs return. Each thread keeps an exponential moving average of
+/// its probe times; slow probes raise the effective probe depth and, at
+/// the extreme, stop probes into the largest piece sets, while fast probes
+/// (a warmed cache) let both decay back to the configured policy. Probes
+/// at high depth always remain enabled, so the average keeps being fed
+/// and recovers once the tables become cheap again.
+
+struct TBThrottle {
+
+  static constexpr int64_t SlowProbe = 2000; // EMA threshold in microseconds
+
+  void update(int64_t us) { latencyEma += (us - latencyEma) / 16; }
+  int  extra_depth() const { return std::min(int(latencyEma / SlowProbe), 10); }
+  bool reduce_cardinality() const { return latencyEma / SlowProbe >= 6; }
+  void reset() { latencyEma = 0; }
+
+  int64_t latencyEma = 0; // Rolling probe latency in microseconds
 };
 
 
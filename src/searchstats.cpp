@@ -0,0 +1,120 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "searchstats.h"
+
+#ifdef USE_STATS
+
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace Stockfish::SearchStats {
+
+namespace {
+
+  // Every thread registers its local counters here on first use, so that
+  // print() and clear() can reach all of them. Registration is rare, so a
+  // plain mutex is fine; counting itself never takes it.
+  std::mutex registryMutex;
+  std::vector<Counters*> registry;
+
+  Counters sum_all() {
+
+    Counters total;
+    std::memset(&total, 0, sizeof(total));
+
+    std::lock_guard<std::mutex> lk(registryMutex);
+    for (const Counters* c : registry)
+    {
+        total.mainNodes        += c->mainNodes;
+        total.qNodes           += c->qNodes;
+        total.ttProbes         += c->ttProbes;
+        total.ttHits           += c->ttHits;
+        total.ttCutoffs        += c->ttCutoffs;
+        total.nullMoveTries    += c->nullMoveTries;
+        total.nullMoveCutoffs  += c->nullMoveCutoffs;
+        total.futilityPrunes   += c->futilityPrunes;
+        total.lmrSearches      += c->lmrSearches;
+        total.lmrReSearches    += c->lmrReSearches;
+        total.betaCutoffs      += c->betaCutoffs;
+
+        for (int i = 0; i < 8; ++i)
+            total.cutoffByMoveIndex[i] += c->cutoffByMoveIndex[i];
+    }
+    return total;
+  }
+
+  double pct(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * double(part) / double(whole) : 0.0;
+  }
+}
+
+
+Counters& local() {
+
+  static thread_local Counters* counters = []() {
+      auto* c = new Counters();
+      std::lock_guard<std::mutex> lk(registryMutex);
+      registry.push_back(c);
+      return c;
+  }();
+  return *counters;
+}
+
+
+void clear() {
+
+  std::lock_guard<std::mutex> lk(registryMutex);
+  for (Counters* c : registry)
+      std::memset(c, 0, sizeof(Counters));
+}
+
+
+void print(std::ostream& os) {
+
+  const Counters t = sum_all();
+  const uint64_t nodes = t.mainNodes + t.qNodes;
+
+  os << std::fixed << std::setprecision(1)
+     << "Search statistics:"
+     << "\nnodes          " << nodes
+     << "\n  main         " << t.mainNodes << " (" << pct(t.mainNodes, nodes) << "%)"
+     << "\n  qsearch      " << t.qNodes    << " (" << pct(t.qNodes, nodes) << "%)"
+     << "\ntt probes      " << t.ttProbes
+     << "\n  hits         " << t.ttHits    << " (" << pct(t.ttHits, t.ttProbes) << "%)"
+     << "\n  cutoffs      " << t.ttCutoffs << " (" << pct(t.ttCutoffs, t.ttProbes) << "%)"
+     << "\nnull move      " << t.nullMoveTries
+     << "\n  cutoffs      " << t.nullMoveCutoffs << " (" << pct(t.nullMoveCutoffs, t.nullMoveTries) << "%)"
+     << "\nfutility       " << t.futilityPrunes
+     << "\nlmr searches   " << t.lmrSearches
+     << "\n  re-searches  " << t.lmrReSearches << " (" << pct(t.lmrReSearches, t.lmrSearches) << "%)"
+     << "\nbeta cutoffs   " << t.betaCutoffs;
+
+  os << "\n  by move index";
+  for (int i = 0; i < 8; ++i)
+      os << ' ' << (i == 7 ? "8+:" : std::to_string(i + 1) + ":")
+         << pct(t.cutoffByMoveIndex[i], t.betaCutoffs) << '%';
+
+  os << std::endl;
+}
+
+} // namespace Stockfish::SearchStats
+
+#endif // USE_STATS
@@ -0,0 +1,72 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEARCHSTATS_H_INCLUDED
+#define SEARCHSTATS_H_INCLUDED
+
+#include <cstdint>
+#include <iostream>
+
+/// Search instrumentation, compiled in with 'make build stats=yes' and free of
+/// any cost otherwise: every probe site goes through the STATS_* macros, which
+/// expand to nothing unless USE_STATS is defined. Counters are kept per thread
+/// to avoid perturbing the hot path with shared-cache-line traffic; the 'stats'
+/// UCI command aggregates and prints them.
+
+namespace Stockfish::SearchStats {
+
+#ifdef USE_STATS
+
+struct Counters {
+
+  uint64_t mainNodes, qNodes;
+  uint64_t ttProbes, ttHits, ttCutoffs;
+  uint64_t nullMoveTries, nullMoveCutoffs;
+  uint64_t futilityPrunes;
+  uint64_t lmrSearches, lmrReSearches;
+  uint64_t betaCutoffs;
+  uint64_t cutoffByMoveIndex[8]; // Histogram over move count, last slot is 8+
+};
+
+// This thread's counters, registered with the global list on first use
+Counters& local();
+
+#define STATS_INC(field) (++Stockfish::SearchStats::local().field)
+
+#define STATS_CUTOFF(moveCount) \
+    (++Stockfish::SearchStats::local().betaCutoffs, \
+     ++Stockfish::SearchStats::local().cutoffByMoveIndex[std::min((moveCount) - 1, 7)])
+
+void print(std::ostream& os);
+void clear();
+
+#else
+
+#define STATS_INC(field)        ((void)0)
+#define STATS_CUTOFF(moveCount) ((void)0)
+
+inline void print(std::ostream& os) {
+  os << "Search statistics not compiled in, rebuild with 'make build stats=yes'" << std::endl;
+}
+inline void clear() {}
+
+#endif
+
+} // namespace Stockfish::SearchStats
+
+#endif // #ifndef SEARCHSTATS_H_INCLUDED
@@ -0,0 +1,159 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "searchtrace.h"
+
+#ifdef USE_SEARCH_TRACE
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "misc.h"
+
+namespace Stockfish::SearchTrace {
+
+std::atomic<bool> tracing{false};
+
+namespace {
+
+  // On-disk header of a trace file, followed by raw Record entries in host
+  // endianness. Records from different threads interleave in drain order;
+  // Record::threadId separates the per-thread streams offline.
+  struct TraceFileHeader {
+    char     magic[8];    // "SFTRACE" + null byte
+    uint32_t version;
+    uint32_t recordBytes; // sizeof(Record), to catch layout mismatches
+  };
+
+  constexpr char TraceFileMagic[8] = { 'S', 'F', 'T', 'R', 'A', 'C', 'E', 0 };
+  constexpr uint32_t TraceFileVersion = 1;
+
+  // Every thread registers its ring here on first use. Registration is rare,
+  // so a plain mutex is fine; push() and the drain loop never take it for
+  // long, and never both for the same ring concurrently.
+  std::mutex registryMutex;
+  std::vector<Ring*> registry;
+
+  std::ofstream out;
+  std::thread writerThread;
+  std::atomic<bool> quitWriter{false};
+
+  // Write everything currently in a ring to the file. Only the writer thread
+  // calls this, so tail moves under no contention.
+  void drain(Ring& ring) {
+
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+
+    while (tail != head)
+    {
+        // Largest contiguous chunk not wrapping around the buffer end
+        uint64_t chunk = std::min(head - tail, Ring::Size - (tail & (Ring::Size - 1)));
+
+        out.write(reinterpret_cast<const char*>(&ring.buf[tail & (Ring::Size - 1)]),
+                  std::streamsize(chunk * sizeof(Record)));
+        tail += chunk;
+    }
+    ring.tail.store(tail, std::memory_order_release);
+  }
+
+  void writer_loop() {
+
+    while (!quitWriter.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        std::lock_guard<std::mutex> lk(registryMutex);
+        for (Ring* ring : registry)
+            drain(*ring);
+    }
+
+    // Final sweep after tracing has been disarmed, so nothing is in flight
+    std::lock_guard<std::mutex> lk(registryMutex);
+    for (Ring* ring : registry)
+        drain(*ring);
+  }
+
+}
+
+
+Ring& local() {
+
+  static thread_local Ring* ring = []() {
+      auto* r = new Ring();
+      std::lock_guard<std::mutex> lk(registryMutex);
+      r->threadId = uint8_t(registry.size());
+      registry.push_back(r);
+      return r;
+  }();
+  return *ring;
+}
+
+
+bool start(const std::string& fname) {
+
+  if (tracing)
+      stop();
+
+  out.open(fname, std::ios::binary);
+  if (!out)
+      return false;
+
+  TraceFileHeader header = {};
+  std::memcpy(header.magic, TraceFileMagic, sizeof(header.magic));
+  header.version     = TraceFileVersion;
+  header.recordBytes = sizeof(Record);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  quitWriter = false;
+  writerThread = std::thread(writer_loop);
+  tracing = true;
+  return true;
+}
+
+
+void stop() {
+
+  if (!tracing)
+      return;
+
+  tracing = false; // Search threads stop posting before the final drain
+  quitWriter = true;
+  writerThread.join();
+
+  uint64_t dropped = 0;
+  {
+      std::lock_guard<std::mutex> lk(registryMutex);
+      for (Ring* ring : registry)
+          dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+  }
+  if (dropped)
+      sync_cout << "info string Search trace dropped " << dropped
+                << " records (ring buffer full)" << sync_endl;
+
+  out.close();
+}
+
+} // namespace Stockfish::SearchTrace
+
+#endif // USE_SEARCH_TRACE
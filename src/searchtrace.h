@@ -0,0 +1,127 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2021 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEARCHTRACE_H_INCLUDED
+#define SEARCHTRACE_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "types.h"
+
+/// Binary search tracing, compiled in with 'make build trace=yes' and free of
+/// any cost otherwise: the TRACE_NODE macro expands to nothing unless
+/// USE_SEARCH_TRACE is defined. When tracing is armed with the 'searchtrace'
+/// UCI command, search threads append fixed-size records to per-thread
+/// single-producer single-consumer ring buffers, and a background writer
+/// thread drains them to a binary file for offline replay and profiling. The
+/// search never blocks on the writer: if a ring fills up, records are dropped
+/// and counted.
+
+namespace Stockfish::SearchTrace {
+
+#ifdef USE_SEARCH_TRACE
+
+// Why a node was left, recorded for offline analysis
+enum Reason : uint8_t {
+  COMPLETED,       // Searched all moves, returned best value
+  BETA_CUTOFF,     // A move failed high
+  TT_CUTOFF,       // Transposition table cutoff
+  NULL_MOVE_CUTOFF // Null move search failed high
+};
+
+// One record per traced event, 16 bytes, written to the file as-is in host
+// endianness. The file starts with a TraceFileHeader (searchtrace.cpp).
+struct Record {
+  uint16_t move;       // Move encoding of types.h, MOVE_NONE if not applicable
+  int16_t  depth;
+  int16_t  staticEval; // VALUE_NONE when not computed at the record site
+  int16_t  alpha;
+  int16_t  beta;
+  int16_t  value;      // Value returned from the node
+  uint8_t  ply;
+  uint8_t  reason;
+  uint8_t  threadId;   // Registration order, not the OS thread id
+  uint8_t  padding;
+};
+
+static_assert(sizeof(Record) == 16, "Unexpected Record size");
+
+// Per-thread ring buffer. The search thread owns head, the writer owns tail;
+// both indices only ever grow, the buffer index is taken modulo Size.
+struct Ring {
+
+  static constexpr uint64_t Size = 1 << 16; // Records, must be a power of two
+
+  void push(const Record& r) {
+
+    uint64_t h = head.load(std::memory_order_relaxed);
+
+    if (h - tail.load(std::memory_order_acquire) >= Size)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buf[h & (Size - 1)] = r;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  Record buf[Size];
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  uint8_t threadId = 0;
+};
+
+// This thread's ring, registered with the global list on first use
+Ring& local();
+
+// Armed while a trace file is open
+extern std::atomic<bool> tracing;
+
+inline void post(int ply, Move m, Depth depth, Value eval,
+                 Value alpha, Value beta, Value value, Reason reason) {
+
+  if (!tracing.load(std::memory_order_relaxed))
+      return;
+
+  Ring& ring = local();
+  ring.push({ uint16_t(m), int16_t(depth), int16_t(eval), int16_t(alpha),
+              int16_t(beta), int16_t(value), uint8_t(ply), uint8_t(reason),
+              ring.threadId, 0 });
+}
+
+#define TRACE_NODE(ply, move, depth, eval, alpha, beta, value, reason) \
+    Stockfish::SearchTrace::post(ply, move, depth, eval, alpha, beta, value, reason)
+
+bool start(const std::string& fname);
+void stop();
+
+#else
+
+#define TRACE_NODE(ply, move, depth, eval, alpha, beta, value, reason) ((void)0)
+
+inline bool start(const std::string&) { return false; }
+inline void stop() {}
+
+#endif
+
+} // namespace Stockfish::SearchTrace
+
+#endif // #ifndef SEARCHTRACE_H_INCLUDED
@@ -1413,10 +1413,72 @@ void Tablebases::init(const std::string& paths) {
 //  0 : draw
 //  1 : win, but draw under 50-move rule
 //  2 : win
+namespace {
+
+// Lock-free cache of final WDL/DTZ probe results. Walking the compressed
+// blocks in do_probe_table() is expensive, and TB-heavy endgame searches
+// probe the same few-piece positions over and over. Entries are validated
+// with the xor trick, so a racy or torn access is detected and just misses.
+struct ProbeCacheEntry {
+    Key     keyXor;
+    int32_t value;
+};
+
+SharedHashTable<ProbeCacheEntry> WDLCache, DTZCache;
+
+bool cache_probe(SharedHashTable<ProbeCacheEntry>& cache, Key key, int& value) {
+
+    if (!cache.enabled())
+        return false;
+
+    ProbeCacheEntry* e = cache[key];
+    int32_t v = e->value;
+
+    if ((e->keyXor ^ Key(int64_t(v))) != key)
+        return false;
+
+    value = v;
+    return true;
+}
+
+void cache_store(SharedHashTable<ProbeCacheEntry>& cache, Key key, int32_t value) {
+
+    if (cache.enabled())
+    {
+        ProbeCacheEntry* e = cache[key];
+        e->value  = value;
+        e->keyXor = key ^ Key(int64_t(value));
+    }
+}
+
+} // namespace
+
+
+/// Tablebases::set_cache_size() sizes the WDL and DTZ probe caches, splitting
+/// the given amount of memory between them. Zero disables caching.
+
+void Tablebases::set_cache_size(size_t mbSize) {
+
+    size_t entries = mbSize * 1024 * 1024 / sizeof(ProbeCacheEntry);
+    WDLCache.resize(entries / 2);
+    DTZCache.resize(entries - entries / 2);
+}
+
+
 WDLScore Tablebases::probe_wdl(Position& pos, ProbeState* result) {
 
     *result = OK;
-    return search<false>(pos, result);
+
+    int cached;
+    if (cache_probe(WDLCache, pos.key(), cached))
+        return WDLScore(cached);
+
+    WDLScore wdl = search<false>(pos, result);
+
+    if (*result != FAIL)
+        cache_store(WDLCache, pos.key(), wdl);
+
+    return wdl;
 }
 
 // Probe the DTZ table for a particular position.
@@ -1445,9 +1507,8 @@ WDLScore Tablebases::probe_wdl(Position& pos, ProbeState* result) {
 //
 // In short, if a move is available resulting in dtz + 50-move-counter <= 99,
 // then do not accept moves leading to dtz + 50-move-counter == 100.
-int Tablebases::probe_dtz(Position& pos, ProbeState* result) {
+static int probe_dtz_impl(Position& pos, ProbeState* result) {
 
-    *result = OK;
     WDLScore wdl = search<true>(pos, result);
 
     if (*result == FAIL || wdl == WDLDraw) // DTZ tables don't store draws
@@ -1482,10 +1543,10 @@ int Tablebases::probe_dtz(Position& pos, ProbeState* result) {
         // position after the move to get the score sign (because even in a
         // winning position we could make a losing capture or going for a draw).
         dtz = zeroing ? -dtz_before_zeroing(search<false>(pos, result))
-                      : -probe_dtz(pos, result);
+                      : -Tablebases::probe_dtz(pos, result);
 
         // If the move mates, force minDTZ to 1
-        if (dtz == 1 && pos.checkers() && MoveList<LEGAL>(pos).size() == 0)
+        if (dtz == 1 && pos.checkers() && !pos.has_legal_moves())
             minDTZ = 1;
 
         // Convert result from 1-ply search. Zeroing moves are already accounted
@@ -1507,6 +1568,22 @@ int Tablebases::probe_dtz(Position& pos, ProbeState* result) {
     return minDTZ == 0xFFFF ? -1 : minDTZ;
 }
 
+int Tablebases::probe_dtz(Position& pos, ProbeState* result) {
+
+    *result = OK;
+
+    int cached;
+    if (cache_probe(DTZCache, pos.key(), cached))
+        return cached;
+
+    int dtz = probe_dtz_impl(pos, result);
+
+    if (*result != FAIL)
+        cache_store(DTZCache, pos.key(), dtz);
+
+    return dtz;
+}
+
 
 // Use the DTZ tables to rank root moves.
 //
@@ -1555,7 +1632,7 @@ bool Tablebases::root_probe(Position& pos, Search::RootMoves& rootMoves) {
         // Make sure that a mating move is assigned a dtz value of 1
         if (   pos.checkers()
             && dtz == 2
-            && MoveList<LEGAL>(pos).size() == 0)
+            && !pos.has_legal_moves())
             dtz = 1;
 
         pos.undo_move(m.pv[0]);
@@ -19,6 +19,8 @@
 #include <cassert>
 
 #include <algorithm> // For std::count
+#include <cstring>   // For std::memcpy
+#include <fstream>
 #include "movegen.h"
 #include "search.h"
 #include "thread.h"
@@ -36,6 +38,11 @@ ThreadPool Threads; // Global object
 
 Thread::Thread(size_t n) : idx(n), stdThread(&Thread::idle_loop, this) {
 
+  // The history clear is deferred to the start of the next search, but the
+  // refresh table must be valid right away: 'eval' and friends evaluate on
+  // this thread without ever entering Thread::search().
+  refreshTable.clear();
+
   wait_for_search_finished();
 }
 
@@ -57,6 +64,8 @@ Thread::~Thread() {
 
 void Thread::clear() {
 
+  refreshTable.clear();
+  tbThrottle.reset();
   counterMoves.fill(MOVE_NONE);
   mainHistory.fill(0);
   lowPlyHistory.fill(0);
@@ -100,10 +109,12 @@ void Thread::idle_loop() {
 
   // If OS already scheduled us on a different group than 0 then don't overwrite
   // the choice, eventually we are one of many one-threaded processes running on
-  // some Windows NUMA hardware, for instance in fishtest. To make it simple,
-  // just check if running threads are below a threshold, in this case all this
-  // NUMA machinery is not needed.
-  if (Options["Threads"] > 8)
+  // some NUMA hardware, for instance in fishtest. To make it simple, with the
+  // default "auto" policy just check if running threads are below a threshold,
+  // in this case all this NUMA machinery is not needed. The "NUMA Policy" UCI
+  // option can force binding on ("all") or off ("none").
+  if (   Options["NUMA Policy"] == "all"
+      || (Options["NUMA Policy"] == "auto" && Options["Threads"] > 8))
       WinProcGroup::bindThisThread(idx);
 
   while (true)
@@ -111,7 +122,26 @@ void Thread::idle_loop() {
       std::unique_lock<std::mutex> lk(mutex);
       searching = false;
       cv.notify_one(); // Wake up anyone waiting for search finished
-      cv.wait(lk, [&]{ return searching; });
+
+      // Spin for a bounded window before parking on the condition variable,
+      // so that back-to-back searches restart without paying the condvar
+      // wakeup and with this thread's caches still warm.
+      TimePoint spinMs = TimePoint(Options["Idle Spin"]);
+
+      if (spinMs)
+      {
+          lk.unlock();
+
+          TimePoint spinUntil = now() + spinMs;
+          int cnt = 0;
+
+          while (!searching && (++cnt & 1023 || now() < spinUntil))
+              spin_pause();
+
+          lk.lock();
+      }
+
+      cv.wait(lk, [&]{ return searching.load(); });
 
       if (exit)
           return;
@@ -153,12 +183,15 @@ void ThreadPool::set(size_t requested) {
 }
 
 
-/// ThreadPool::clear() sets threadPool data to initial values
+/// ThreadPool::clear() sets threadPool data to initial values. Zeroing the
+/// history tables of every thread here would stall the UCI thread for hundreds
+/// of milliseconds at high thread counts, so they are only marked dirty and
+/// each thread clears its own tables, in parallel, when it next searches.
 
 void ThreadPool::clear() {
 
   for (Thread* th : *this)
-      th->clear();
+      th->clearHistories = true;
 
   main()->callsCnt = 0;
   main()->bestPreviousScore = VALUE_INFINITE;
@@ -188,6 +221,19 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
   if (!rootMoves.empty())
       Tablebases::rank_root_moves(pos, rootMoves);
 
+  // Partitioned MultiPV: split the PV lines into contiguous slices, each
+  // searched concurrently by its own group of threads. Thread i joins group
+  // i % pvGroups, so the main thread always owns the slice with the best line.
+  size_t multiPV = std::min(size_t(Options["MultiPV"]), rootMoves.size());
+  pvGroups = std::min(size_t(Options["MultiPV Groups"]), std::min(multiPV, size()));
+  pvOrderReady = false;
+  pvOrder.clear();
+
+  // Skill handicap picks among the full set of lines, so it needs every
+  // thread to search all of them.
+  if (Options["UCI_LimitStrength"] || int(Options["Skill Level"]) < 20)
+      pvGroups = 1;
+
   // After ownership transfer 'states' becomes empty, so if we stop the search
   // and call 'go' again without setting a new position states.get() == NULL.
   assert(states.get() || setupStates.get());
@@ -205,13 +251,47 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
       th->nodes = th->tbHits = th->nmpMinPly = th->bestMoveChanges = 0;
       th->rootDepth = th->completedDepth = 0;
       th->rootMoves = rootMoves;
+
+      if (pvGroups > 1)
+      {
+          size_t group = th->id() % pvGroups;
+          th->pvOffset = multiPV * group / pvGroups;
+          th->pvCount = multiPV * (group + 1) / pvGroups - th->pvOffset;
+      }
+      else
+      {
+          th->pvOffset = 0;
+          th->pvCount = 0; // Search all lines
+      }
+
       th->rootPos.set(pos.fen(), pos.is_chess960(), &th->rootState, th);
+
+      // The struct copy would drag the shared back() state's accumulator
+      // pointer along, leaving every thread computing into one block owned
+      // by the UCI position's pool. Keep the block from the thread's own
+      // pool that set() just attached instead.
+      Eval::NNUE::Accumulator* rootAcc = th->rootState.accumulator;
       th->rootState = setupStates->back();
+      th->rootState.accumulator = rootAcc;
+      rootAcc->computed[WHITE] = rootAcc->computed[BLACK] = false;
   }
 
   main()->start_searching();
 }
 
+
+/// ThreadPool::reclaim_states() hands the state list back to the UCI layer,
+/// which may want to extend it in place for an incremental position setup.
+/// The StateInfo objects themselves do not move, so pointers into the list
+/// held by the current position stay valid across the ownership round trip.
+
+StateListPtr ThreadPool::reclaim_states() {
+
+  main()->wait_for_search_finished();
+  return std::move(setupStates);
+}
+
+
 Thread* ThreadPool::get_best_thread() const {
 
     Thread* bestThread = front();
@@ -244,6 +324,40 @@ Thread* ThreadPool::get_best_thread() const {
 }
 
 
+/// ThreadPool::merge_pv_groups() collects, for every PV slice owned by another
+/// group, the slice of the deepest thread of that group into the main thread,
+/// then sorts the combined lines, so that the full MultiPV set can be printed
+/// from there. All threads keep the same set of moves within a slice, hence
+/// entries can be copied by index.
+
+void ThreadPool::merge_pv_groups() {
+
+    MainThread* mainTh = main();
+    size_t pvTotal = mainTh->pvCount;
+
+    for (Thread* th : *this)
+        if (th->pvOffset != mainTh->pvOffset)
+        {
+            pvTotal = std::max(pvTotal, th->pvOffset + th->pvCount);
+
+            // The deepest thread of each group provides its slice
+            bool deepest = true;
+            for (Thread* other : *this)
+                if (   other != th
+                    && other->pvOffset == th->pvOffset
+                    && (   other->completedDepth > th->completedDepth
+                        || (other->completedDepth == th->completedDepth && other->id() < th->id())))
+                    deepest = false;
+
+            if (deepest)
+                for (size_t i = th->pvOffset; i < th->pvOffset + th->pvCount; ++i)
+                    mainTh->rootMoves[i] = th->rootMoves[i];
+        }
+
+    std::stable_sort(mainTh->rootMoves.begin(), mainTh->rootMoves.begin() + pvTotal);
+}
+
+
 /// Start non-main threads
 
 void ThreadPool::start_searching() {
@@ -263,4 +377,140 @@ void ThreadPool::wait_for_search_finished() const {
             th->wait_for_search_finished();
 }
 
+
+namespace {
+
+  // On-disk header preceding the serialized heuristic tables
+  struct HeuristicsFileHeader {
+    char     magic[8];      // "SFHEUR" + two null bytes
+    uint32_t version;       // Bumped whenever a table layout changes
+    uint64_t payloadBytes;  // Total table bytes following the header
+  };
+
+  constexpr char HeuristicsFileMagic[8] = { 'S', 'F', 'H', 'E', 'U', 'R', 0, 0 };
+  constexpr uint32_t HeuristicsFileVersion = 1;
+
+  constexpr size_t HeuristicsPayloadBytes =  sizeof(ButterflyHistory)
+                                           + sizeof(LowPlyHistory)
+                                           + sizeof(CapturePieceToHistory)
+                                           + 4 * sizeof(ContinuationHistory)
+                                           + sizeof(CounterMoveHistory);
+
+  // Writes one history table merged across all threads: the per-thread
+  // int16 entries are averaged, which is what a single thread would most
+  // plausibly have learned. Stats tables are standard-layout arrays of
+  // StatsEntry (see Stats::fill()), so they can be walked as flat int16.
+  // The selector maps a thread to the table instance being serialized.
+  template<typename Selector>
+  void write_merged(std::ofstream& ofs, Selector sel) {
+
+    using Table = std::remove_reference_t<decltype(sel(*Threads.main()))>;
+    constexpr size_t entries = sizeof(Table) / sizeof(int16_t);
+    std::vector<int16_t> merged(entries);
+
+    for (size_t i = 0; i < entries; ++i)
+    {
+        int sum = 0;
+        for (Thread* th : Threads)
+            sum += reinterpret_cast<const int16_t*>(&sel(*th))[i];
+        merged[i] = int16_t(sum / int(Threads.size()));
+    }
+
+    ofs.write(reinterpret_cast<const char*>(merged.data()), sizeof(Table));
+  }
+
+  // Reads one history table and broadcasts it to every thread
+  template<typename Selector>
+  void read_broadcast(std::ifstream& ifs, Selector sel) {
+
+    using Table = std::remove_reference_t<decltype(sel(*Threads.main()))>;
+    ifs.read(reinterpret_cast<char*>(&sel(*Threads.main())), sizeof(Table));
+
+    for (Thread* th : Threads)
+        if (th != Threads.main())
+            std::memcpy(&sel(*th), &sel(*Threads.main()), sizeof(Table));
+  }
+}
+
+
+/// ThreadPool::save_heuristics() serializes the per-thread history tables to
+/// a file, merged across threads, so that a resumed analysis session can get
+/// its move ordering back instead of re-learning it from a cold start. The
+/// natural companion of 'savehash'.
+
+bool ThreadPool::save_heuristics(const std::string& fname) const {
+
+  main()->wait_for_search_finished();
+
+  std::ofstream ofs(fname, std::ios::binary);
+
+  if (!ofs)
+      return false;
+
+  HeuristicsFileHeader header = {};
+  std::memcpy(header.magic, HeuristicsFileMagic, sizeof(header.magic));
+  header.version      = HeuristicsFileVersion;
+  header.payloadBytes = HeuristicsPayloadBytes;
+
+  ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  write_merged(ofs, [](Thread& th) -> ButterflyHistory& { return th.mainHistory; });
+  write_merged(ofs, [](Thread& th) -> LowPlyHistory& { return th.lowPlyHistory; });
+  write_merged(ofs, [](Thread& th) -> CapturePieceToHistory& { return th.captureHistory; });
+
+  for (int inCheck : { 0, 1 })
+      for (int c : { 0, 1 })
+          write_merged(ofs, [inCheck, c](Thread& th) -> ContinuationHistory& {
+                            return th.continuationHistory[inCheck][c]; });
+
+  // Counter moves are moves, not averageable weights: save the main thread's
+  ofs.write(reinterpret_cast<const char*>(&main()->counterMoves), sizeof(CounterMoveHistory));
+
+  return bool(ofs);
+}
+
+
+/// ThreadPool::load_heuristics() restores tables written by save_heuristics(),
+/// broadcasting them to every thread. The pending lazy history clear is
+/// cancelled so the loaded state survives into the next search; note that a
+/// later 'ucinewgame' re-arms it and discards the loaded tables as usual.
+
+bool ThreadPool::load_heuristics(const std::string& fname) {
+
+  main()->wait_for_search_finished();
+
+  std::ifstream ifs(fname, std::ios::binary);
+
+  if (!ifs)
+      return false;
+
+  HeuristicsFileHeader header;
+  ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  if (   !ifs
+      || std::memcmp(header.magic, HeuristicsFileMagic, sizeof(header.magic)) != 0
+      || header.version != HeuristicsFileVersion
+      || header.payloadBytes != HeuristicsPayloadBytes)
+      return false;
+
+  read_broadcast(ifs, [](Thread& th) -> ButterflyHistory& { return th.mainHistory; });
+  read_broadcast(ifs, [](Thread& th) -> LowPlyHistory& { return th.lowPlyHistory; });
+  read_broadcast(ifs, [](Thread& th) -> CapturePieceToHistory& { return th.captureHistory; });
+
+  for (int inCheck : { 0, 1 })
+      for (int c : { 0, 1 })
+          read_broadcast(ifs, [inCheck, c](Thread& th) -> ContinuationHistory& {
+                              return th.continuationHistory[inCheck][c]; });
+
+  read_broadcast(ifs, [](Thread& th) -> CounterMoveHistory& { return th.counterMoves; });
+
+  if (!ifs)
+      return false;
+
+  for (Thread* th : *this)
+      th->clearHistories = false;
+
+  return true;
+}
+
 } // namespace Stockfish
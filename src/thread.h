@@ -44,7 +44,8 @@ class Thread {
   std::mutex mutex;
   std::condition_variable cv;
   size_t idx;
-  bool exit = false, searching = true; // Set before starting std::thread
+  bool exit = false;                      // Set before starting std::thread
+  std::atomic_bool searching { true };    // Atomic, so the idle loop can spin on it
   NativeThread stdThread;
 
 public:
@@ -59,8 +60,12 @@ public:
 
   Pawns::Table pawnsTable;
   Material::Table materialTable;
+  Eval::NNUE::AccumulatorRefreshTable refreshTable;
   size_t pvIdx, pvLast;
+  size_t pvOffset, pvCount; // Slice of PV lines owned in partitioned MultiPV mode
+  bool clearHistories = true; // Histories are zeroed lazily at the next search
   uint64_t ttHitAverage;
+  Search::TBThrottle tbThrottle;
   int selDepth, nmpMinPly;
   Color nmpColor;
   std::atomic<uint64_t> nodes, tbHits, bestMoveChanges;
@@ -69,6 +74,16 @@ public:
   StateInfo rootState;
   Search::RootMoves rootMoves;
   Depth rootDepth, completedDepth;
+  // Per-ply arenas for the search. The PV lines and the searched-move lists
+  // used to live in the recursive frames of search() and qsearch(); keeping
+  // them here shrinks native stack usage per ply by over a kilobyte (deep
+  // analysis otherwise needs the oversized stacks from thread_win32_osx.h)
+  // and keeps each ply's state contiguous. Row i of pvArena backs the child
+  // PV of the node at ply i-1, the other arenas are indexed by ply directly.
+  Move pvArena[MAX_PLY + 2][MAX_PLY + 1];
+  Move quietsArena[MAX_PLY + 2][64];
+  Move capturesArena[MAX_PLY + 2][32];
+
   CounterMoveHistory counterMoves;
   ButterflyHistory mainHistory;
   LowPlyHistory lowPlyHistory;
@@ -103,8 +118,11 @@ struct MainThread : public Thread {
 struct ThreadPool : public std::vector<Thread*> {
 
   void start_thinking(Position&, StateListPtr&, const Search::LimitsType&, bool = false);
+  StateListPtr reclaim_states();
   void clear();
   void set(size_t);
+  bool save_heuristics(const std::string& fname) const;
+  bool load_heuristics(const std::string& fname);
 
   MainThread* main()        const { return static_cast<MainThread*>(front()); }
   uint64_t nodes_searched() const { return accumulate(&Thread::nodes); }
@@ -112,8 +130,12 @@ struct ThreadPool : public std::vector<Thread*> {
   Thread* get_best_thread() const;
   void start_searching();
   void wait_for_search_finished() const;
+  void merge_pv_groups();
 
   std::atomic_bool stop, increaseDepth;
+  size_t pvGroups = 1;
+  std::atomic_bool pvOrderReady; // Set once the main thread has published pvOrder
+  std::vector<Move> pvOrder;     // Shared line ranking in partitioned MultiPV mode
 
 private:
   StateListPtr setupStates;
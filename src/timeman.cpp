@@ -40,6 +40,46 @@ void TimeManagement::init(Search::LimitsType& limits, Color us, int ply) {
   TimePoint slowMover       = TimePoint(Options["Slow Mover"]);
   TimePoint npmsec          = TimePoint(Options["nodestime"]);
 
+  // Compare the clock the GUI just sent against the state snapshotted when
+  // our previous bestmove went out: whatever was deducted beyond our own
+  // measured search time is round-trip latency. The overhead term adapts
+  // online to the observed distribution, so a static "Move Overhead" only
+  // acts as a lower bound on jittery connections.
+  bool newSample = false;
+
+  if (prevValid && us == prevUs && limits.time[us])
+  {
+      TimePoint lost = prevTimeLeft + prevInc - limits.time[us] - prevSearchTime;
+
+      if (lost >= 0 && lost <= 1000)
+      {
+          latencyLast = lost;
+          latencyMax = std::max(latencyMax, lost);
+
+          // Exponentially weighted mean and deviation of the samples
+          latencyAvg = latencySamples ? 0.8 * latencyAvg + 0.2 * lost : double(lost);
+          latencyDev = 0.8 * latencyDev + 0.2 * std::abs(lost - latencyAvg);
+          latencySamples++;
+          newSample = true;
+      }
+  }
+  prevValid = false;
+
+  if (latencySamples)
+  {
+      // Cover the mean plus a generous margin for jitter
+      TimePoint calibrated = TimePoint(latencyAvg + 4.0 * latencyDev) + 5;
+      moveOverhead = std::max(moveOverhead, calibrated);
+
+      if (newSample)
+          sync_cout << "info string latency last " << latencyLast
+                    << " avg " << int(latencyAvg)
+                    << " dev " << int(latencyDev)
+                    << " max " << latencyMax
+                    << " samples " << latencySamples
+                    << " overhead " << moveOverhead << sync_endl;
+  }
+
   // optScale is a percentage of available time to use for the current move.
   // maxScale is a multiplier applied to optimumTime.
   double optScale, maxScale;
@@ -98,4 +138,33 @@ void TimeManagement::init(Search::LimitsType& limits, Color us, int ply) {
       optimumTime += optimumTime / 4;
 }
 
+
+/// TimeManagement::on_bestmove() snapshots the clock state at the moment the
+/// bestmove is sent to the GUI, so that the next init() can deduce how much
+/// time the round-trip cost us. Pondering keeps our clock running outside of
+/// the search, so those snapshots are not usable for calibration.
+
+void TimeManagement::on_bestmove(Color us) {
+
+  prevValid =   Search::Limits.use_time_management()
+             && !Search::Limits.npmsec
+             && !Options["Ponder"];
+  prevUs = us;
+  prevTimeLeft = Search::Limits.time[us];
+  prevInc = Search::Limits.inc[us];
+  prevSearchTime = now() - startTime;
+}
+
+
+/// TimeManagement::reset_calibration() forgets the measured latency, typically
+/// on 'ucinewgame' when the engine may be handed over to a different GUI.
+
+void TimeManagement::reset_calibration() {
+
+  prevValid = false;
+  latencySamples = 0;
+  latencyLast = latencyMax = 0;
+  latencyAvg = latencyDev = 0;
+}
+
 } // namespace Stockfish
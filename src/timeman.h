@@ -31,6 +31,8 @@ namespace Stockfish {
 class TimeManagement {
 public:
   void init(Search::LimitsType& limits, Color us, int ply);
+  void on_bestmove(Color us);
+  void reset_calibration();
   TimePoint optimum() const { return optimumTime; }
   TimePoint maximum() const { return maximumTime; }
   TimePoint elapsed() const { return Search::Limits.npmsec ?
@@ -42,6 +44,15 @@ private:
   TimePoint startTime;
   TimePoint optimumTime;
   TimePoint maximumTime;
+
+  // Latency auto-calibration: clock state snapshotted when the previous
+  // bestmove was sent, and running statistics of the observed GUI latency.
+  bool prevValid = false;
+  Color prevUs = WHITE;
+  TimePoint prevTimeLeft = 0, prevInc = 0, prevSearchTime = 0;
+  int latencySamples = 0;
+  TimePoint latencyLast = 0, latencyMax = 0;
+  double latencyAvg = 0, latencyDev = 0;
 };
 
 extern TimeManagement Time;
@@ -17,9 +17,18 @@
 */
 
 #include <cstring>   // For std::memset
+#include <fstream>
 #include <iostream>
 #include <thread>
 
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "bitboard.h"
 #include "misc.h"
 #include "thread.h"
@@ -30,6 +39,33 @@ namespace Stockfish {
 
 TranspositionTable TT; // Our global transposition table
 
+namespace {
+
+  // On-disk header preceding the raw Cluster array in a saved hash file
+  struct HashFileHeader {
+    char     magic[8];      // "SFHASH" + two null bytes
+    uint32_t version;       // Bumped whenever the TTEntry layout changes
+    uint32_t clusterSize;   // sizeof(Cluster), as a sanity check
+    uint64_t clusterCount;
+    uint8_t  generation;
+    char     pad;
+    uint16_t epoch;
+    char     padding[4];    // Keep the mapped clusters 32-byte aligned
+  };
+
+  static_assert(sizeof(HashFileHeader) == 32, "Unexpected HashFileHeader size");
+
+  constexpr char HashFileMagic[8] = { 'S', 'F', 'H', 'A', 'S', 'H', 0, 0 };
+
+  // The compact layout keeps sizeof(Cluster) at 32 bytes, so a different
+  // version number is what stops files from crossing between the two layouts.
+#ifdef USE_COMPACT_TT
+  constexpr uint32_t HashFileVersion = 2;
+#else
+  constexpr uint32_t HashFileVersion = 1;
+#endif
+}
+
 /// TTEntry::save() populates the TTEntry with a new node's data, possibly
 /// overwriting an old position. Update is not atomic and can be racy.
 
@@ -51,7 +87,11 @@ void TTEntry::save(Key k, Value v, bool pv, Bound b, Depth d, Move m, Value ev)
       depth8    = (uint8_t)(d - DEPTH_OFFSET);
       genBound8 = (uint8_t)(TT.generation8 | uint8_t(pv) << 2 | b);
       value16   = (int16_t)v;
+#ifdef USE_COMPACT_TT
+      (void)ev; // The compact entry has no room for the static eval
+#else
       eval16    = (int16_t)ev;
+#endif
   }
 }
 
@@ -64,10 +104,24 @@ void TranspositionTable::resize(size_t mbSize) {
 
   Threads.main()->wait_for_search_finished();
 
-  aligned_large_pages_free(table);
+  release();
 
   clusterCount = mbSize * 1024 * 1024 / sizeof(Cluster);
 
+  // Cooperating engine processes on the same host can share one table
+  // through a named shared-memory segment: the lock-free racy cluster
+  // writes that make the table safe under many threads make it equally
+  // safe under many processes.
+  std::string shmName(Options["Shared Hash Name"]);
+  if (!shmName.empty())
+  {
+      if (attach_shared(shmName, mbSize))
+          return;
+
+      sync_cout << "info string Failed to attach shared hash '" << shmName
+                << "', using a private table" << sync_endl;
+  }
+
   table = static_cast<Cluster*>(aligned_large_pages_alloc(clusterCount * sizeof(Cluster)));
   if (!table)
   {
@@ -76,23 +130,61 @@ void TranspositionTable::resize(size_t mbSize) {
       exit(EXIT_FAILURE);
   }
 
-  clear();
+  // Spread the table across the NUMA nodes before full_clear() touches it,
+  // unless the user asked us to leave memory placement alone
+  if (!(Options["NUMA Policy"] == "none"))
+      numa_interleave(table, clusterCount * sizeof(Cluster));
+
+  // Report the page size we really got: with explicitly reserved huge pages it
+  // is guaranteed, while the transparent-hugepage fallback is best effort only.
+  size_t pageSize = large_page_size(table);
+  sync_cout << "info string Hash " << mbSize << "MB allocated with "
+            << (pageSize ? std::to_string(pageSize >> 20) + "MB pages"
+                         : "transparent huge pages (best effort)") << sync_endl;
+
+  full_clear();
 }
 
 
-/// TranspositionTable::clear() initializes the entire transposition table to zero,
-//  in a multi-threaded way.
+/// TranspositionTable::clear() makes the whole table logically empty. With the
+/// "Lazy Hash Clear" option enabled this is O(1): the table-wide epoch is
+/// bumped and probe() treats clusters from a previous epoch as empty, so
+/// 'ucinewgame' turnaround no longer depends on the hash size. Only when the
+/// 16-bit epoch would wrap, and stale clusters could alias the new epoch, is a
+/// real clear needed again.
 
 void TranspositionTable::clear() {
 
+#ifndef USE_COMPACT_TT
+  if (Options["Lazy Hash Clear"] && epoch16 < 0xFFFF)
+  {
+      ++epoch16;
+      return;
+  }
+#endif
+
+  full_clear();
+}
+
+
+/// TranspositionTable::full_clear() initializes the entire transposition table
+//  to zero, in a multi-threaded way.
+
+void TranspositionTable::full_clear() {
+
+  epoch16 = 0;
+
   std::vector<std::thread> threads;
 
   for (size_t idx = 0; idx < Options["Threads"]; ++idx)
   {
       threads.emplace_back([this, idx]() {
 
-          // Thread binding gives faster search on systems with a first-touch policy
-          if (Options["Threads"] > 8)
+          // Thread binding gives faster search on systems with a first-touch
+          // policy: each bound thread zeroes, and so places on its local node,
+          // the part of the hash table it will mostly access later.
+          if (   Options["NUMA Policy"] == "all"
+              || (Options["NUMA Policy"] == "auto" && Options["Threads"] > 8))
               WinProcGroup::bindThisThread(idx);
 
           // Each thread will zero its part of the hash table
@@ -110,6 +202,80 @@ void TranspositionTable::clear() {
 }
 
 
+/// TranspositionTable::attach_shared() places the cluster array in a named
+/// shared-memory segment so that several engine processes probing the same
+/// game tree pool their hash instead of each keeping a private copy. The
+/// first process creates the segment (the kernel hands it out zero-filled,
+/// so no explicit clear is needed); later ones attach to it, provided their
+/// Hash size matches the segment. The segment outlives the processes until
+/// it is removed (e.g. under /dev/shm), so accumulated search survives
+/// restarts too. Generation and epoch counters stay per-process: a mismatch
+/// only perturbs replacement decisions or re-zeroes a cluster on first
+/// touch, which the racy-write design already tolerates, though cooperating
+/// processes should start new games in lockstep to avoid needless wipes.
+
+bool TranspositionTable::attach_shared(const std::string& name, size_t mbSize) {
+
+#if !defined(_WIN32)
+
+  size_t size = clusterCount * sizeof(Cluster);
+  bool created = true;
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+  if (fd < 0 && errno == EEXIST)
+  {
+      created = false;
+      fd = shm_open(name.c_str(), O_RDWR, 0600);
+  }
+
+  if (fd < 0)
+      return false;
+
+  if (created && ftruncate(fd, off_t(size)) != 0)
+  {
+      ::close(fd);
+      shm_unlink(name.c_str());
+      return false;
+  }
+
+  // When attaching, the segment must match our own Hash size or first_entry()
+  // would index the clusters differently than the process that created it.
+  struct stat sb;
+  if (fstat(fd, &sb) != 0 || size_t(sb.st_size) != size)
+      return ::close(fd), false;
+
+  void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (mem == MAP_FAILED)
+  {
+      if (created)
+          shm_unlink(name.c_str());
+      return false;
+  }
+
+  mapping     = mem;
+  mappingSize = size;
+  table       = static_cast<Cluster*>(mem);
+  epoch16     = 0;
+
+  sync_cout << "info string Hash " << mbSize << "MB "
+            << (created ? "created as" : "attached to")
+            << " shared segment '" << name << "'" << sync_endl;
+
+  return true;
+
+#else
+
+  // No POSIX shared memory on Windows: fall back to a private table
+  (void)name, (void)mbSize;
+  return false;
+
+#endif
+}
+
+
 /// TranspositionTable::probe() looks up the current position in the transposition
 /// table. It returns true and a pointer to the TTEntry if the position is found.
 /// Otherwise, it returns false and a pointer to an empty or least valuable TTEntry
@@ -119,9 +285,21 @@ void TranspositionTable::clear() {
 
 TTEntry* TranspositionTable::probe(const Key key, bool& found) const {
 
-  TTEntry* const tte = first_entry(key);
+  Cluster& cluster = table[mul_hi64(key, clusterCount)];
+  TTEntry* const tte = cluster.entry;
   const uint16_t key16 = (uint16_t)key;  // Use the low 16 bits as key inside the cluster
 
+#ifndef USE_COMPACT_TT
+  // A cluster last written in a previous epoch is logically empty, so
+  // reinitialize it on first touch. Like any other TT write this is racy,
+  // which is harmless.
+  if (cluster.epoch16 != epoch16)
+  {
+      std::memset(cluster.entry, 0, sizeof(cluster.entry));
+      cluster.epoch16 = epoch16;
+  }
+#endif
+
   for (int i = 0; i < ClusterSize; ++i)
       if (tte[i].key16 == key16 || !tte[i].depth8)
       {
@@ -130,7 +308,11 @@ TTEntry* TranspositionTable::probe(const Key key, bool& found) const {
           return found = (bool)tte[i].depth8, &tte[i];
       }
 
-  // Find an entry to be replaced according to the replacement strategy
+  // Find an entry to be replaced according to the replacement strategy.
+  // Entries saved at PV nodes get a protection bonus worth a few plies of
+  // depth, so principal variations are not the first casualties when the
+  // hash saturates and eviction pressure rises.
+  constexpr int PvProtection = 10;
   TTEntry* replace = tte;
   for (int i = 1; i < ClusterSize; ++i)
       // Due to our packed storage format for generation and its cyclic
@@ -138,8 +320,10 @@ TTEntry* TranspositionTable::probe(const Key key, bool& found) const {
       // is needed to keep the unrelated lowest n bits from affecting
       // the result) to calculate the entry age correctly even after
       // generation8 overflows into the next cycle.
-      if (  replace->depth8 - ((GENERATION_CYCLE + generation8 - replace->genBound8) & GENERATION_MASK)
-          >   tte[i].depth8 - ((GENERATION_CYCLE + generation8 -   tte[i].genBound8) & GENERATION_MASK))
+      if (  replace->depth8 + PvProtection * replace->is_pv()
+            - ((GENERATION_CYCLE + generation8 - replace->genBound8) & GENERATION_MASK)
+          >   tte[i].depth8 + PvProtection * tte[i].is_pv()
+            - ((GENERATION_CYCLE + generation8 -   tte[i].genBound8) & GENERATION_MASK))
           replace = &tte[i];
 
   return found = false, replace;
@@ -153,10 +337,159 @@ int TranspositionTable::hashfull() const {
 
   int cnt = 0;
   for (int i = 0; i < 1000; ++i)
+  {
+#ifndef USE_COMPACT_TT
+      if (table[i].epoch16 != epoch16)
+          continue;
+#endif
       for (int j = 0; j < ClusterSize; ++j)
-          cnt += table[i].entry[j].depth8 && (table[i].entry[j].genBound8 & GENERATION_MASK) == generation8;
+          cnt +=  table[i].entry[j].depth8
+               && (table[i].entry[j].genBound8 & GENERATION_MASK) == generation8;
+  }
 
   return cnt / ClusterSize;
 }
 
+
+/// TranspositionTable::release() frees the cluster array, which is either an
+/// allocation made by resize() or a view into a memory-mapped hash file.
+
+void TranspositionTable::release() {
+
+#if !defined(_WIN32)
+  if (mapping)
+  {
+      munmap(mapping, mappingSize);
+      mapping = nullptr;
+      mappingSize = 0;
+      table = nullptr;
+      return;
+  }
+#endif
+
+  aligned_large_pages_free(table);
+  table = nullptr;
+}
+
+
+/// TranspositionTable::save() dumps the cluster array to a file, preceded by a
+/// small header, so that accumulated search can survive a process restart.
+
+bool TranspositionTable::save(const std::string& fname) const {
+
+  Threads.main()->wait_for_search_finished();
+
+  std::ofstream ofs(fname, std::ios::binary);
+
+  if (!ofs)
+      return false;
+
+  HashFileHeader header = {};
+  std::memcpy(header.magic, HashFileMagic, sizeof(header.magic));
+  header.version      = HashFileVersion;
+  header.clusterSize  = uint32_t(sizeof(Cluster));
+  header.clusterCount = clusterCount;
+  header.generation   = generation8;
+  header.epoch        = epoch16;
+
+  ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<const char*>(table), clusterCount * sizeof(Cluster));
+
+  return bool(ofs);
+}
+
+
+/// TranspositionTable::load() replaces the current table with the content of a
+/// file written by save(). On POSIX systems the file is memory-mapped privately
+/// (copy-on-write), so loading a many-gigabyte hash is nearly instantaneous and
+/// pages are only faulted in as probes touch them. Returns false and leaves the
+/// current table untouched if the file is missing or malformed.
+
+bool TranspositionTable::load(const std::string& fname) {
+
+  Threads.main()->wait_for_search_finished();
+
+#if !defined(_WIN32)
+
+  int fd = ::open(fname.c_str(), O_RDONLY);
+
+  if (fd < 0)
+      return false;
+
+  struct stat sb;
+  if (fstat(fd, &sb) != 0)
+      return ::close(fd), false;
+
+  void* mem = mmap(nullptr, sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (mem == MAP_FAILED)
+      return false;
+
+  const HashFileHeader* header = static_cast<const HashFileHeader*>(mem);
+
+  if (   size_t(sb.st_size) < sizeof(HashFileHeader)
+      || std::memcmp(header->magic, HashFileMagic, sizeof(header->magic)) != 0
+      || header->version != HashFileVersion
+      || header->clusterSize != sizeof(Cluster)
+      || size_t(sb.st_size) != sizeof(HashFileHeader) + header->clusterCount * sizeof(Cluster))
+  {
+      munmap(mem, sb.st_size);
+      return false;
+  }
+
+  release();
+
+  mapping      = mem;
+  mappingSize  = size_t(sb.st_size);
+  table        = reinterpret_cast<Cluster*>(static_cast<char*>(mem) + sizeof(HashFileHeader));
+  clusterCount = header->clusterCount;
+  generation8  = header->generation;
+  epoch16      = header->epoch;
+
+  return true;
+
+#else
+
+  // Without a portable mmap path, read the file into a freshly allocated table
+  std::ifstream ifs(fname, std::ios::binary);
+
+  if (!ifs)
+      return false;
+
+  HashFileHeader header;
+  ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  if (   !ifs
+      || std::memcmp(header.magic, HashFileMagic, sizeof(header.magic)) != 0
+      || header.version != HashFileVersion
+      || header.clusterSize != sizeof(Cluster))
+      return false;
+
+  Cluster* newTable =
+      static_cast<Cluster*>(aligned_large_pages_alloc(size_t(header.clusterCount) * sizeof(Cluster)));
+
+  if (!newTable)
+      return false;
+
+  ifs.read(reinterpret_cast<char*>(newTable), size_t(header.clusterCount) * sizeof(Cluster));
+
+  if (!ifs)
+  {
+      aligned_large_pages_free(newTable);
+      return false;
+  }
+
+  release();
+
+  table        = newTable;
+  clusterCount = size_t(header.clusterCount);
+  generation8  = header.generation;
+  epoch16      = header.epoch;
+
+  return true;
+
+#endif
+}
+
 } // namespace Stockfish
@@ -34,12 +34,22 @@ namespace Stockfish {
 /// move       16 bit
 /// value      16 bit
 /// eval value 16 bit
+///
+/// When compiled with USE_COMPACT_TT the cached static evaluation is dropped
+/// and the entry shrinks to 8 bytes, so a 32-byte cluster holds 4 entries
+/// instead of 3 and the same RAM stores a third more positions. eval() then
+/// returns VALUE_NONE and the search re-evaluates, which it already must
+/// handle for entries saved without an eval.
 
 struct TTEntry {
 
   Move  move()  const { return (Move )move16; }
   Value value() const { return (Value)value16; }
+#ifdef USE_COMPACT_TT
+  Value eval()  const { return VALUE_NONE; }
+#else
   Value eval()  const { return (Value)eval16; }
+#endif
   Depth depth() const { return (Depth)depth8 + DEPTH_OFFSET; }
   bool is_pv()  const { return (bool)(genBound8 & 0x4); }
   Bound bound() const { return (Bound)(genBound8 & 0x3); }
@@ -53,7 +63,9 @@ private:
   uint8_t  genBound8;
   uint16_t move16;
   int16_t  value16;
+#ifndef USE_COMPACT_TT
   int16_t  eval16;
+#endif
 };
 
 
@@ -65,12 +77,24 @@ private:
 
 class TranspositionTable {
 
+#ifdef USE_COMPACT_TT
+  // Four 8-byte entries fill the cluster completely, leaving no room for the
+  // lazy-clear epoch: with this layout 'Lazy Hash Clear' degrades to a full
+  // clear, a deliberate trade of new-game latency for hash capacity.
+  static constexpr int ClusterSize = 4;
+
+  struct Cluster {
+    TTEntry entry[ClusterSize];
+  };
+#else
   static constexpr int ClusterSize = 3;
 
   struct Cluster {
     TTEntry entry[ClusterSize];
-    char padding[2]; // Pad to 32 bytes
+    uint16_t epoch16; // Lazy-clear epoch, pads to 32 bytes. Clusters written
+                      // in a previous epoch are treated as empty by probe().
   };
+#endif
 
   static_assert(sizeof(Cluster) == 32, "Unexpected Cluster size");
 
@@ -81,12 +105,14 @@ class TranspositionTable {
   static constexpr int      GENERATION_MASK  = (0xFF << GENERATION_BITS) & 0xFF; // mask to pull out generation number
 
 public:
- ~TranspositionTable() { aligned_large_pages_free(table); }
+ ~TranspositionTable() { release(); }
   void new_search() { generation8 += GENERATION_DELTA; } // Lower bits are used for other things
   TTEntry* probe(const Key key, bool& found) const;
   int hashfull() const;
   void resize(size_t mbSize);
   void clear();
+  bool save(const std::string& fname) const;
+  bool load(const std::string& fname);
 
   TTEntry* first_entry(const Key key) const {
     return &table[mul_hi64(key, clusterCount)].entry[0];
@@ -95,9 +121,16 @@ public:
 private:
   friend struct TTEntry;
 
+  void release();
+  void full_clear();
+  bool attach_shared(const std::string& name, size_t mbSize);
+
   size_t clusterCount;
   Cluster* table;
+  void* mapping;       // Base of the memory-mapped hash file, if any
+  size_t mappingSize;
   uint8_t generation8; // Size must be not bigger than TTEntry::genBound8
+  uint16_t epoch16;    // Table-wide epoch matched against Cluster::epoch16
 };
 
 extern TranspositionTable TT;
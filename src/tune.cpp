@@ -17,9 +17,14 @@
 */
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
+#include "movegen.h"
+#include "position.h"
+#include "search.h"
+#include "thread.h"
 #include "types.h"
 #include "misc.h"
 #include "uci.h"
@@ -31,6 +36,9 @@ namespace Stockfish {
 bool Tune::update_on_last;
 const UCI::Option* LastOption = nullptr;
 static std::map<std::string, int> TuneResults;
+// Options created through TUNE(), in creation order, with their ranges
+struct TuneOption { string name; int min, max; };
+static std::vector<TuneOption> TuneOptions;
 
 string Tune::next(string& names, bool pop) {
 
@@ -68,6 +76,7 @@ static void make_option(const string& n, int v, const SetRange& r) {
 
   Options[n] << UCI::Option(v, r(v).first, r(v).second, on_tune);
   LastOption = &Options[n];
+  TuneOptions.push_back({ n, r(v).first, r(v).second });
 
   // Print formatted parameters, ready to be copy-pasted in Fishtest
   std::cout << n << ","
@@ -109,6 +118,182 @@ template<> void Tune::Entry<Score>::read_option() {
 template<> void Tune::Entry<Tune::PostUpdate>::init_option() {}
 template<> void Tune::Entry<Tune::PostUpdate>::read_option() { value(); }
 
+
+namespace {
+
+  // The search output of thousands of fast games would drown the tuning
+  // report, so cout is muted while they are being played.
+  struct CoutSilencer {
+    CoutSilencer() : buf(std::cout.rdbuf(nullptr)) {}
+   ~CoutSilencer() { std::cout.rdbuf(buf); }
+    std::streambuf* buf;
+  };
+
+  // Assign a parameter vector to the Tune-generated options. Values reach the
+  // tuned variables through the regular on_tune() handler, exactly as if a
+  // GUI had sent them.
+  void set_params(const std::vector<double>& theta) {
+
+    for (size_t i = 0; i < TuneOptions.size(); ++i)
+        Options[TuneOptions[i].name] = std::to_string(int(std::round(theta[i])));
+  }
+
+  // Search the given position with a fixed node budget and return the best move
+  Move search_move(const Position& pos, int64_t nodes) {
+
+    Search::LimitsType limits;
+    limits.nodes = nodes;
+    limits.startTime = now();
+
+    StateListPtr states(new StateList(1));
+    Position root;
+    root.set(pos.fen(), pos.is_chess960(), &states->back(), Threads.main());
+
+    Threads.start_thinking(root, states, limits, false);
+    Threads.main()->wait_for_search_finished();
+
+    return Threads.main()->rootMoves[0].pv[0];
+  }
+
+  // Play a single game between the two perturbed parameter sets, starting
+  // from the given opening. Returns the score of the 'plus' set: 1 for a win,
+  // 1/2 for a draw, 0 for a loss. Games too long to be useful are adjudicated
+  // as draws.
+  double play_game(const string& fen, Color plusColor,
+                   const std::vector<double>& thetaPlus,
+                   const std::vector<double>& thetaMinus, int64_t nodes) {
+
+    StateListPtr states(new StateList(1));
+    Position pos;
+    pos.set(fen, false, &states->back(), Threads.main());
+
+    for (int ply = 0; ply < 400; ++ply)
+    {
+        if (!pos.has_legal_moves())
+            return !pos.checkers()                  ? 0.5
+                 : pos.side_to_move() == plusColor  ? 0.0 : 1.0;
+
+        if (pos.is_draw(ply))
+            return 0.5;
+
+        set_params(pos.side_to_move() == plusColor ? thetaPlus : thetaMinus);
+
+        Move m = search_move(pos, nodes);
+        states->emplace_back();
+        pos.do_move(m, states->back());
+    }
+
+    return 0.5;
+  }
+
+  const char* StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+  // Build a short random opening so that game pairs do not all retrace the
+  // same moves out of a resident transposition table.
+  string random_opening(PRNG& rng) {
+
+    while (true)
+    {
+        StateListPtr states(new StateList(1));
+        Position pos;
+        pos.set(StartFEN, false, &states->back(), Threads.main());
+
+        int plies = 4 + rng.rand<unsigned>() % 4;
+        while (plies--)
+        {
+            MoveList<LEGAL> ml(pos);
+            if (!ml.size())
+                break;
+
+            states->emplace_back();
+            pos.do_move(ml.begin()[rng.rand<unsigned>() % ml.size()], states->back());
+        }
+
+        if (pos.has_legal_moves() && !pos.is_draw(0))
+            return pos.fen();
+    }
+  }
+}
+
+
+/// Tune::spsa() implements the 'spsa' command: an in-process SPSA tuning
+/// session over the parameters registered with TUNE(). Each iteration plays a
+/// pair of fast fixed-nodes games between a positively and a negatively
+/// perturbed parameter set, with colors swapped on the same opening, and moves
+/// the parameters toward the winner. Because both "engines" are this process,
+/// the transposition table and network weights stay resident and no UCI
+/// round-trips or process spawns are needed.
+///
+/// Usage: spsa [iterations] [nodes per move]
+
+void Tune::spsa(std::istringstream& is) {
+
+  if (TuneOptions.empty())
+  {
+      std::cout << "No parameters registered for tuning. Remove the const "
+                   "qualifier from the\nvariables to tune, flag them with "
+                   "TUNE() and recompile." << std::endl;
+      return;
+  }
+
+  string token;
+  size_t iterations = (is >> token) ? size_t(stoll(token)) : 100;
+  int64_t nodes     = (is >> token) ? stoll(token) : 10000;
+
+  const size_t n = TuneOptions.size();
+
+  std::vector<double> theta(n), c(n), minv(n), maxv(n);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+      theta[i] = double(int(Options[TuneOptions[i].name]));
+      minv[i]  = TuneOptions[i].min;
+      maxv[i]  = TuneOptions[i].max;
+      c[i]     = std::max((maxv[i] - minv[i]) / 20.0, 1.0);
+  }
+
+  // Same learning setup as printed by make_option() for fishtest sessions
+  constexpr double R = 0.0020, Gamma = 0.101;
+
+  PRNG rng(now());
+  double total = 0;
+
+  for (size_t k = 1; k <= iterations; ++k)
+  {
+      std::vector<double> delta(n), thetaPlus(n), thetaMinus(n);
+
+      for (size_t i = 0; i < n; ++i)
+      {
+          double ck = c[i] / std::pow(double(k), Gamma);
+          delta[i]      = rng.rand<unsigned>() % 2 ? ck : -ck;
+          thetaPlus[i]  = std::clamp(theta[i] + delta[i], minv[i], maxv[i]);
+          thetaMinus[i] = std::clamp(theta[i] - delta[i], minv[i], maxv[i]);
+      }
+
+      // A game pair with colors swapped cancels the opening bias
+      string fen = random_opening(rng);
+      double score;
+      {
+          CoutSilencer silencer;
+          score = play_game(fen, WHITE, thetaPlus, thetaMinus, nodes)
+                + play_game(fen, BLACK, thetaPlus, thetaMinus, nodes) - 1.0;
+      }
+      total += score;
+
+      for (size_t i = 0; i < n; ++i)
+          theta[i] = std::clamp(theta[i] + R * delta[i] * score, minv[i], maxv[i]);
+
+      std::cout << "iteration " << k << "/" << iterations
+                << " score " << score << " total " << total << std::endl;
+  }
+
+  set_params(theta);
+
+  std::cout << "\nTuned values:" << std::endl;
+  for (size_t i = 0; i < n; ++i)
+      std::cout << "  " << TuneOptions[i].name << " = " << int(std::round(theta[i])) << std::endl;
+}
+
 } // namespace Stockfish
 
 
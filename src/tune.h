@@ -20,6 +20,7 @@
 #define TUNE_H_INCLUDED
 
 #include <memory>
+#include <sstream>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -147,6 +148,7 @@ public:
   }
   static void init() { for (auto& e : instance().list) e->init_option(); read_options(); } // Deferred, due to UCI::Options access
   static void read_options() { for (auto& e : instance().list) e->read_option(); }
+  static void spsa(std::istringstream& is); // In-process SPSA tuning ('spsa' command)
   static bool update_on_last;
 };
 
@@ -18,17 +18,26 @@
 
 #include <cassert>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
+#include "cluster.h"
 #include "evaluate.h"
 #include "movegen.h"
 #include "position.h"
 #include "search.h"
+#include "searchstats.h"
+#include "searchtrace.h"
 #include "thread.h"
 #include "timeman.h"
 #include "tt.h"
+#include "tune.h"
 #include "uci.h"
 #include "syzygy/tbprobe.h"
 
@@ -51,6 +60,12 @@ namespace {
 
   void position(Position& pos, istringstream& is, StateListPtr& states) {
 
+    // The previous command's FEN, applied moves and resulting key, used to
+    // detect that a new command merely extends the old one.
+    static string prevFen;
+    static vector<string> prevMoves;
+    static Key prevKey;
+
     Move m;
     string token, fen;
 
@@ -67,15 +82,42 @@ namespace {
     else
         return;
 
-    states = StateListPtr(new std::deque<StateInfo>(1)); // Drop old and create a new one
-    pos.set(fen, Options["UCI_Chess960"], &states->back(), Threads.main());
+    vector<string> moves;
+    while (is >> token)
+        moves.push_back(token);
+
+    // Analysis GUIs re-send the whole game after every new move, so commands
+    // usually extend the previous one. In that case replay only the new
+    // suffix instead of redoing the entire move list from scratch. A 'go'
+    // moves the state list into the thread pool, so reclaim it first.
+    if (!states)
+        states = Threads.reclaim_states();
+
+    size_t done = 0;
+
+    if (   states
+        && states->size() == prevMoves.size() + 1
+        && fen == prevFen
+        && moves.size() >= prevMoves.size()
+        && equal(prevMoves.begin(), prevMoves.end(), moves.begin())
+        && pos.key() == prevKey)
+        done = prevMoves.size();
+    else
+    {
+        states = StateListPtr(new StateList(1)); // Drop old and create a new one
+        pos.set(fen, Options["UCI_Chess960"], &states->back(), Threads.main());
+    }
 
-    // Parse move list (if any)
-    while (is >> token && (m = UCI::to_move(pos, token)) != MOVE_NONE)
+    // Apply the (remaining) move list
+    for (; done < moves.size() && (m = UCI::to_move(pos, moves[done])) != MOVE_NONE; ++done)
     {
         states->emplace_back();
         pos.do_move(m, states->back());
     }
+
+    prevFen = fen;
+    prevMoves.assign(moves.begin(), moves.begin() + done);
+    prevKey = pos.key();
   }
 
   // trace_eval() prints the evaluation for the current position, consistent with the UCI
@@ -83,7 +125,7 @@ namespace {
 
   void trace_eval(Position& pos) {
 
-    StateListPtr states(new std::deque<StateInfo>(1));
+    StateListPtr states(new StateList(1));
     Position p;
     p.set(pos.fen(), Options["UCI_Chess960"], &states->back(), Threads.main());
 
@@ -93,6 +135,110 @@ namespace {
   }
 
 
+  // evalbatch() streams a file of FENs through the evaluation function for
+  // offline dataset generation: "evalbatch <fenfile> [outfile]". Positions are
+  // still set up one by one, but the per-position costs of the "eval" command
+  // are amortized across the stream: a single StateInfo is reused, the
+  // per-thread accumulator refresh table persists between positions, scores
+  // are collected in memory and written to <outfile> (default "scores.bin")
+  // in one buffered pass as little-endian int16, and no text is formatted.
+  // Positions with the side to move in check cannot be evaluated statically
+  // and get the sentinel score VALUE_NONE.
+
+  void evalbatch(istringstream& is) {
+
+    string fenFile, outFile = "scores.bin";
+
+    if (!(is >> fenFile))
+    {
+        sync_cout << "FEN file required, e.g. 'evalbatch fens.txt scores.bin'" << sync_endl;
+        return;
+    }
+    is >> outFile;
+
+    ifstream in(fenFile);
+    if (!in)
+    {
+        sync_cout << "Unable to open file " << fenFile << sync_endl;
+        return;
+    }
+
+    Eval::NNUE::verify();
+
+    TimePoint elapsed = now();
+    StateInfo st;
+    Position p;
+    string fen;
+    std::vector<int16_t> scores;
+    scores.reserve(1 << 20);
+
+    while (getline(in, fen))
+    {
+        if (fen.empty())
+            continue;
+
+        p.set(fen, Options["UCI_Chess960"], &st, Threads.main());
+        scores.push_back(int16_t(p.checkers() ? VALUE_NONE : Eval::evaluate(p)));
+    }
+
+    elapsed = now() - elapsed + 1; // Ensure positivity to avoid a 'divide by zero'
+
+    ofstream out(outFile, ios::binary);
+    if (IsLittleEndian)
+        out.write(reinterpret_cast<const char*>(scores.data()),
+                  streamsize(scores.size() * sizeof(int16_t)));
+    else
+        for (int16_t v : scores)
+        {
+            out.put(char(uint16_t(v) & 0xFF));
+            out.put(char(uint16_t(v) >> 8));
+        }
+
+    cerr << "\n==========================="
+         << "\nPositions evaluated : " << scores.size()
+         << "\nTotal time (ms)     : " << elapsed
+         << "\nPositions/second    : " << 1000 * int64_t(scores.size()) / elapsed << endl;
+  }
+
+
+  // nnuebench() runs the NNUE forward pass kernel benchmark over a small
+  // fixed position set spanning the game phases: "nnuebench [iterations]"
+  // (default 10000). The per-layer timing itself lives in
+  // Eval::NNUE::benchmark(); this just sets up the positions.
+
+  void nnuebench(istringstream& is) {
+
+    constexpr const char* Fens[] = {
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+      "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+      "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+      "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+      "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+      "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/3N4 b - - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11"
+    };
+    constexpr int PositionCount = sizeof(Fens) / sizeof(Fens[0]);
+
+    int iterations = 10000;
+    string token;
+    if (is >> token)
+        iterations = std::max(atoi(token.c_str()), 1);
+
+    StateInfo states[PositionCount];
+    Position p[PositionCount];
+    std::vector<Position*> positions;
+
+    for (int i = 0; i < PositionCount; ++i)
+    {
+        p[i].set(Fens[i], false, &states[i], Threads.main());
+        positions.push_back(&p[i]);
+    }
+
+    Eval::NNUE::benchmark(positions, iterations);
+  }
+
+
   // setoption() is called when engine receives the "setoption" UCI command. The
   // function updates the UCI option ("name") to the given value ("value").
 
@@ -147,7 +293,115 @@ namespace {
         else if (token == "infinite")  limits.infinite = 1;
         else if (token == "ponder")    ponderMode = true;
 
-    Threads.start_thinking(pos, states, limits, ponderMode);
+    // With workers configured and limits the coordinator can drive, split
+    // the root moves across the cluster instead of searching them all here
+    if (!ponderMode && Cluster::available(limits))
+        Cluster::go(pos, states, limits);
+    else
+        Threads.start_thinking(pos, states, limits, ponderMode);
+  }
+
+
+  // bench_matrix() sweeps threads x hash x depth, repeating each cell a
+  // number of times and reporting median and standard deviation of the
+  // nodes/second, one machine-readable line per cell so that successive
+  // runs can be diffed. With a trailing "perf" token, hardware counters
+  // (cycles, cache and branch misses) are sampled around the searches.
+  // Usage: bench matrix [threads] [hash] [depth] [reps] [evaltype] [perf]
+  // where threads, hash and depth accept comma-separated lists.
+
+  void bench_matrix(Position& pos, istream& args, StateListPtr& states) {
+
+    string threadsCsv = "1", hashCsv = "16", depthCsv = "13", evalType = "mixed", token;
+    int reps = 3;
+    bool usePerf = false;
+
+    args >> threadsCsv >> hashCsv >> depthCsv >> reps >> evalType;
+    args.clear();
+
+    if (args >> token)
+        usePerf = (token == "perf");
+
+    auto parse_csv = [](const string& csv) {
+        vector<int> v;
+        istringstream ss(csv);
+        string item;
+        while (getline(ss, item, ','))
+            v.push_back(stoi(item));
+        return v;
+    };
+
+    for (int threads : parse_csv(threadsCsv))
+        for (int hash : parse_csv(hashCsv))
+            for (int depth : parse_csv(depthCsv))
+            {
+                vector<double> npsSamples;
+                uint64_t cellNodes = 0;
+                PerfEventGroup perf;
+
+                // Counters must be armed before the "setoption name Threads"
+                // command recreates the workers, so that they are inherited.
+                bool perfOk = usePerf && perf.start();
+
+                for (int rep = 0; rep < reps; ++rep)
+                {
+                    string params =   to_string(hash) + " " + to_string(threads) + " "
+                                    + to_string(depth) + " default depth " + evalType;
+                    istringstream is(params);
+                    uint64_t nodes = 0;
+                    TimePoint elapsed = now();
+
+                    for (const auto& cmd : setup_bench(pos, is))
+                    {
+                        istringstream cis(cmd);
+                        cis >> skipws >> token;
+
+                        if (token == "go")
+                        {
+                            go(pos, cis, states);
+                            Threads.main()->wait_for_search_finished();
+                            nodes += Threads.nodes_searched();
+                        }
+                        else if (token == "setoption")  setoption(cis);
+                        else if (token == "position")   position(pos, cis, states);
+                        else if (token == "ucinewgame") { Search::clear(); elapsed = now(); }
+                    }
+
+                    elapsed = now() - elapsed + 1;
+                    npsSamples.push_back(1000.0 * nodes / elapsed);
+                    cellNodes += nodes;
+                }
+
+                if (perfOk)
+                    perf.stop();
+
+                sort(npsSamples.begin(), npsSamples.end());
+
+                double median = reps % 2 ? npsSamples[reps / 2]
+                                         : (npsSamples[reps / 2 - 1] + npsSamples[reps / 2]) / 2;
+                double mean = 0, var = 0;
+                for (double s : npsSamples)
+                    mean += s / reps;
+                for (double s : npsSamples)
+                    var += (s - mean) * (s - mean) / reps;
+
+                cerr << "matrix"
+                     << " threads=" << threads
+                     << " hash=" << hash
+                     << " depth=" << depth
+                     << " reps=" << reps
+                     << " nodes=" << cellNodes
+                     << " median_nps=" << uint64_t(median)
+                     << " stddev_nps=" << uint64_t(std::sqrt(var));
+
+                if (perfOk)
+                    cerr << " cycles=" << perf.cycles
+                         << " l1d_miss=" << perf.l1dMisses
+                         << " llc_miss=" << perf.llcMisses
+                         << " branch_miss=" << perf.branchMisses;
+
+                cerr << endl;
+            }
   }
 
 
@@ -157,10 +411,20 @@ namespace {
 
   void bench(Position& pos, istream& args, StateListPtr& states) {
 
-    string token;
+    string token, allArgs;
     uint64_t num, nodes = 0, cnt = 1;
 
-    vector<string> list = setup_bench(pos, args);
+    getline(args, allArgs);
+    istringstream iss(allArgs);
+
+    if (iss >> token && token == "matrix")
+        return bench_matrix(pos, iss, states);
+
+    iss.clear();
+    iss.str(allArgs);
+    iss.seekg(0);
+
+    vector<string> list = setup_bench(pos, iss);
     num = count_if(list.begin(), list.end(), [](string s) { return s.find("go ") == 0 || s.find("eval") == 0; });
 
     TimePoint elapsed = now();
@@ -195,6 +459,10 @@ namespace {
          << "\nTotal time (ms) : " << elapsed
          << "\nNodes searched  : " << nodes
          << "\nNodes/second    : " << 1000 * nodes / elapsed << endl;
+
+#ifdef USE_STATS
+    SearchStats::print(cerr);
+#endif
   }
 
   // The win rate model returns the probability (per mille) of winning given an eval
@@ -232,16 +500,80 @@ void UCI::loop(int argc, char* argv[]) {
 
   Position pos;
   string token, cmd;
-  StateListPtr states(new std::deque<StateInfo>(1));
+  StateListPtr states(new StateList(1));
 
   pos.set(StartFEN, false, &states->back(), Threads.main());
 
   for (int i = 1; i < argc; ++i)
       cmd += std::string(argv[i]) + " ";
 
+  // Worker mode has to rebind stdin before the input reader thread below
+  // starts blocking on the old one, so 'serve' is only accepted as a
+  // command-line argument: './stockfish serve 9001'. Afterwards the normal
+  // loop transparently reads from and writes to the connection.
+  if (argc == 3 && cmd.compare(0, 6, "serve ") == 0)
+  {
+      Cluster::serve(atoi(argv[2]));
+      cmd.clear();
+      argc = 1;
+  }
+
+  // Commands are read by a dedicated input thread, so that time-critical ones
+  // take effect immediately even while this loop is busy executing a previous
+  // command (clearing a big hash, running 'bench', parsing a long position).
+  // The reader raises Threads.stop, respectively unsets pondering, itself the
+  // instant 'stop', 'quit' or 'ponderhit' arrive, then queues the line here.
+  std::mutex qMutex;
+  std::condition_variable qCv;
+  std::deque<string> pending;
+  bool eof = false;
+
+  std::thread reader;
+  if (argc == 1)
+      reader = std::thread([&] {
+
+          string line, t;
+          while (getline(cin, line))
+          {
+              istringstream is(line);
+              t.clear();
+              is >> skipws >> t;
+
+              if (t == "quit" || t == "stop")
+                  Threads.stop = true;
+
+              else if (t == "ponderhit")
+                  Threads.main()->ponder = false; // Switch to normal search
+
+              {
+                  std::lock_guard<std::mutex> lk(qMutex);
+                  pending.push_back(line);
+              }
+              qCv.notify_one();
+
+              if (t == "quit")
+                  return;
+          }
+
+          std::lock_guard<std::mutex> lk(qMutex);
+          eof = true;
+          qCv.notify_one();
+      });
+
   do {
-      if (argc == 1 && !getline(cin, cmd)) // Block here waiting for input or EOF
-          cmd = "quit";
+      if (argc == 1)
+      {
+          std::unique_lock<std::mutex> lk(qMutex);
+          qCv.wait(lk, [&]{ return !pending.empty() || eof; });
+
+          if (pending.empty()) // EOF: ensure gracefully exiting if the GUI dies
+              cmd = "quit";
+          else
+          {
+              cmd = pending.front();
+              pending.pop_front();
+          }
+      }
 
       istringstream is(cmd);
 
@@ -276,7 +608,49 @@ void UCI::loop(int argc, char* argv[]) {
       else if (token == "bench")    bench(pos, is, states);
       else if (token == "d")        sync_cout << pos << sync_endl;
       else if (token == "eval")     trace_eval(pos);
+      else if (token == "evalbatch") evalbatch(is);
+      else if (token == "nnuebench") nnuebench(is);
+      else if (token == "serve")
+          sync_cout << "Worker mode must be started from the command line, "
+                       "e.g. './stockfish serve 9001'" << sync_endl;
       else if (token == "compiler") sync_cout << compiler_info() << sync_endl;
+      else if (token == "stats")    { std::cout << IO_LOCK; SearchStats::print(std::cout); std::cout << IO_UNLOCK; }
+      else if (token == "searchtrace")
+      {
+          std::string f;
+          is >> f;
+          if (f == "stop")
+          {
+              SearchTrace::stop();
+              sync_cout << "Search trace stopped" << sync_endl;
+          }
+          else if (SearchTrace::start(f.empty() ? "search.trace" : f))
+              sync_cout << "Search trace started" << sync_endl;
+          else
+              sync_cout << "Unable to start a search trace: file not writable, or "
+                           "tracing not compiled in (rebuild with 'make build trace=yes')" << sync_endl;
+      }
+      else if (token == "spsa")     Tune::spsa(is);
+      else if (token == "savehash" || token == "loadhash")
+      {
+          std::string f;
+          if (!(is >> skipws >> f))
+              sync_cout << "Filename required, e.g. '" << token << " hash.bin'" << sync_endl;
+          else if (token == "savehash" ? TT.save(f) : TT.load(f))
+              sync_cout << "Hash " << (token == "savehash" ? "saved to " : "loaded from ") << f << sync_endl;
+          else
+              sync_cout << "Failed to " << (token == "savehash" ? "save hash to " : "load hash from ") << f << sync_endl;
+      }
+      else if (token == "saveheuristics" || token == "loadheuristics")
+      {
+          std::string f;
+          if (!(is >> skipws >> f))
+              sync_cout << "Filename required, e.g. '" << token << " heur.bin'" << sync_endl;
+          else if (token == "saveheuristics" ? Threads.save_heuristics(f) : Threads.load_heuristics(f))
+              sync_cout << "Heuristics " << (token == "saveheuristics" ? "saved to " : "loaded from ") << f << sync_endl;
+          else
+              sync_cout << "Failed to " << (token == "saveheuristics" ? "save heuristics to " : "load heuristics from ") << f << sync_endl;
+      }
       else if (token == "export_net")
       {
           std::optional<std::string> filename;
@@ -285,10 +659,23 @@ void UCI::loop(int argc, char* argv[]) {
               filename = f;
           Eval::NNUE::save_eval(filename);
       }
+      else if (token == "export_mapped_net")
+      {
+          std::string f;
+          if (!(is >> skipws >> f))
+              sync_cout << "Filename required, e.g. 'export_mapped_net net.map'" << sync_endl;
+          else if (Eval::NNUE::save_mapped_eval(f))
+              sync_cout << "Mapped network saved to " << f << sync_endl;
+          else
+              sync_cout << "Failed to export a mapped network" << sync_endl;
+      }
       else if (!token.empty() && token[0] != '#')
           sync_cout << "Unknown command: " << cmd << sync_endl;
 
   } while (token != "quit" && argc == 1); // Command line args are one-shot
+
+  if (reader.joinable())
+      reader.join();
 }
 
 
@@ -365,6 +752,73 @@ string UCI::move(Move m, bool chess960) {
 }
 
 
+/// The InfoWriter appenders mirror UCI::move(), UCI::value() and UCI::wdl()
+/// above, but format straight into the writer's fixed buffer.
+
+UCI::InfoWriter& UCI::InfoWriter::move(Move m, bool chess960) {
+
+  if (m == MOVE_NONE)
+      return *this << "(none)";
+
+  if (m == MOVE_NULL)
+      return *this << "0000";
+
+  Square from = from_sq(m);
+  Square to = to_sq(m);
+
+  if (type_of(m) == CASTLING && !chess960)
+      to = make_square(to > from ? FILE_G : FILE_C, rank_of(from));
+
+  *this << char('a' + file_of(from)) << char('1' + rank_of(from))
+        << char('a' + file_of(to))   << char('1' + rank_of(to));
+
+  if (type_of(m) == PROMOTION)
+      *this << " pnbrqk"[promotion_type(m)];
+
+  return *this;
+}
+
+UCI::InfoWriter& UCI::InfoWriter::value(Value v) {
+
+  assert(-VALUE_INFINITE < v && v < VALUE_INFINITE);
+
+  if (abs(v) < VALUE_MATE_IN_MAX_PLY)
+      return *this << "cp " << v * 100 / PawnValueEg;
+
+  return *this << "mate " << (v > 0 ? VALUE_MATE - v + 1 : -VALUE_MATE - v) / 2;
+}
+
+UCI::InfoWriter& UCI::InfoWriter::wdl(Value v, int ply) {
+
+  int wdl_w = win_rate_model( v, ply);
+  int wdl_l = win_rate_model(-v, ply);
+
+  return *this << " wdl " << wdl_w << ' ' << 1000 - wdl_w - wdl_l << ' ' << wdl_l;
+}
+
+void UCI::InfoWriter::flush() {
+
+  if (!len)
+      return;
+
+  std::cout << IO_LOCK;
+  std::cout.write(buf, std::streamsize(len));
+  std::cout.flush();
+  std::cout << IO_UNLOCK;
+  len = 0;
+}
+
+
+/// UCI::writer() gives each thread its own InfoWriter, so formatting needs
+/// no synchronization; only the final bulk write takes the output lock.
+
+UCI::InfoWriter& UCI::writer() {
+
+  static thread_local InfoWriter w;
+  return w;
+}
+
+
 /// UCI::to_move() converts a string representing a move in coordinate notation
 /// (g1f3, a7a8q) to the corresponding legal Move, if any.
 
@@ -67,12 +67,65 @@ private:
   OnChange on_change;
 };
 
+/// InfoWriter formats engine output into a fixed preallocated buffer that is
+/// handed to the stream in one bulk write, so the hot emission paths (PV and
+/// currmove lines) never touch the heap, no matter how often they fire. The
+/// buffer auto-flushes when full; flush() takes the same lock as sync_cout,
+/// so writer output cannot interleave with lines from other threads.
+
+class InfoWriter {
+
+  static constexpr size_t BufSize = 16 * 1024;
+
+public:
+  InfoWriter& operator<<(char c) {
+    if (len == BufSize)
+        flush();
+    buf[len++] = c;
+    return *this;
+  }
+  InfoWriter& operator<<(const char* s) {
+    while (*s)
+        *this << *s++;
+    return *this;
+  }
+  InfoWriter& operator<<(unsigned long long v) {
+    char digits[20];
+    int n = 0;
+    do
+        digits[n++] = char('0' + v % 10);
+    while (v /= 10);
+    while (n)
+        *this << digits[--n];
+    return *this;
+  }
+  InfoWriter& operator<<(long long v) {
+    if (v < 0)
+        *this << '-', v = -v;
+    return *this << (unsigned long long)v;
+  }
+  InfoWriter& operator<<(int v)           { return *this << (long long)v; }
+  InfoWriter& operator<<(long v)          { return *this << (long long)v; }
+  InfoWriter& operator<<(unsigned v)      { return *this << (unsigned long long)v; }
+  InfoWriter& operator<<(unsigned long v) { return *this << (unsigned long long)v; }
+
+  InfoWriter& move(Move m, bool chess960);
+  InfoWriter& value(Value v);
+  InfoWriter& wdl(Value v, int ply);
+  void flush();
+
+private:
+  size_t len = 0;
+  char buf[BufSize];
+};
+
 void init(OptionsMap&);
 void loop(int argc, char* argv[]);
+InfoWriter& writer(); // Per-thread InfoWriter instance
 std::string value(Value v);
 std::string square(Square s);
 std::string move(Move m, bool chess960);
-std::string pv(const Position& pos, Depth depth, Value alpha, Value beta);
+void pv(const Position& pos, Depth depth, Value alpha, Value beta);
 std::string wdl(Value v, int ply);
 Move to_move(const Position& pos, std::string& str);
 
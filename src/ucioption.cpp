@@ -21,6 +21,7 @@
 #include <ostream>
 #include <sstream>
 
+#include "book.h"
 #include "evaluate.h"
 #include "misc.h"
 #include "search.h"
@@ -40,9 +41,20 @@ namespace UCI {
 /// 'On change' actions, triggered by an option's value change
 void on_clear_hash(const Option&) { Search::clear(); }
 void on_hash_size(const Option& o) { TT.resize(size_t(o)); }
+void on_shared_hash(const Option&) { TT.resize(size_t(Options["Hash"])); }
 void on_logger(const Option& o) { start_logger(o); }
+void on_telemetry(const Option& o) { Telemetry::open(o); }
+void on_book(const Option& o) { Book::init(o); }
 void on_threads(const Option& o) { Threads.set(size_t(o)); }
 void on_tb_path(const Option& o) { Tablebases::init(o); }
+void on_tb_cache(const Option& o) { Tablebases::set_cache_size(size_t(o)); }
+void on_ext_bitbases(const Option& o) { if (o) Bitbases::init_extended(); }
+void on_shared_eval_hash(const Option& o) {
+  if (Threads.size())
+      Threads.main()->wait_for_search_finished();
+  Pawns::set_shared_size(size_t(o) * 3 / 4);    // Pawn entries dominate, so
+  Material::set_shared_size(size_t(o) - size_t(o) * 3 / 4); // give them most of the budget
+}
 void on_use_NNUE(const Option& ) { Eval::NNUE::init(); }
 void on_eval_file(const Option& ) { Eval::NNUE::init(); }
 
@@ -61,11 +73,21 @@ void init(OptionsMap& o) {
   constexpr int MaxHashMB = Is64Bit ? 33554432 : 2048;
 
   o["Debug Log File"]        << Option("", on_logger);
+  o["Telemetry File"]        << Option("", on_telemetry);
   o["Threads"]               << Option(1, 1, 512, on_threads);
   o["Hash"]                  << Option(16, 1, MaxHashMB, on_hash_size);
   o["Clear Hash"]            << Option(on_clear_hash);
+  o["Lazy Hash Clear"]       << Option(false);
+  o["Shared Eval Hash"]      << Option(0, 0, 4096, on_shared_eval_hash);
+  o["Shared Hash Name"]      << Option("", on_shared_hash);
+  o["Cluster Hosts"]         << Option("");
+  o["NUMA Policy"]           << Option("auto var auto var all var none", "auto");
   o["Ponder"]                << Option(false);
+  o["Book File"]             << Option("", on_book);
+  o["Book Depth"]            << Option(100, 1, 100);
+  o["Idle Spin"]             << Option(0, 0, 100);
   o["MultiPV"]               << Option(1, 1, 500);
+  o["MultiPV Groups"]        << Option(1, 1, 16);
   o["Skill Level"]           << Option(20, 0, 20);
   o["Move Overhead"]         << Option(10, 0, 5000);
   o["Slow Mover"]            << Option(100, 10, 1000);
@@ -79,6 +101,8 @@ void init(OptionsMap& o) {
   o["SyzygyProbeDepth"]      << Option(1, 1, 100);
   o["Syzygy50MoveRule"]      << Option(true);
   o["SyzygyProbeLimit"]      << Option(7, 0, 7);
+  o["SyzygyProbeCache"]      << Option(0, 0, 1024, on_tb_cache);
+  o["Extended Bitbases"]     << Option(false, on_ext_bitbases);
   o["Use NNUE"]              << Option(true, on_use_NNUE);
   o["EvalFile"]              << Option(EvalFileDefaultName, on_eval_file);
 }